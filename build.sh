@@ -5,13 +5,45 @@ echo "Building project..."
 cpp_files=(
     "src/boot/boot.cpp"
     "src/cartridge/cartridge.cpp"
+    "src/cartridge/cartridge_header.cpp"
+    "src/cartridge/cartridge_ram.cpp"
+    "src/cartridge/rom_index.cpp"
+    "src/cartridge/rom_store.cpp"
+    "src/cartridge/rtc.cpp"
     "src/cpu/cpu.cpp"
     "src/cpu/interrupts.cpp"
+    "src/joypad/joypad.cpp"
+    "src/memory/dma.cpp"
+    "src/memory/high_ram.cpp"
     "src/memory/mmu.cpp"
+    "src/memory/oam.cpp"
+    "src/memory/video_ram.cpp"
+    "src/memory/work_ram.cpp"
+    "src/ppu/color_converter.cpp"
+    "src/ppu/fifo_renderer.cpp"
+    "src/ppu/object_table.cpp"
+    "src/ppu/ppu.cpp"
+    "src/ppu/scanline_renderer.cpp"
+    "src/ppu/tile_cache.cpp"
+    "src/scheduler/scheduler.cpp"
+    "src/serial/local_link.cpp"
+    "src/serial/serial.cpp"
+    "src/serial/socket_link.cpp"
+    "src/state/movie.cpp"
+    "src/state/snapshot.cpp"
+    "src/timer/timer.cpp"
     "src/utils/loader.cpp"
+    "src/utils/mapped_file.cpp"
+    "src/gameboy.cpp"
     "src/main.cpp"
 )
 
+tools=(
+    "src/tools/movie_player.cpp"
+    "src/tools/ppu_compare.cpp"
+    "src/tools/rom_indexer.cpp"
+)
+
 include_dirs=(
     "-Isrc"
     "-I/usr/local/Cellar/sdl2/2.0.12_1/include"
@@ -26,6 +58,10 @@ libs=(
 )
 
 clang++ -O3 -std=c++2a -fcoroutines-ts ${include_dirs[@]} ${lib_dirs[@]} ${libs[@]} ${cpp_files[@]}
+
+for tool in ${tools[@]}; do
+    clang++ -O3 -std=c++2a -fcoroutines-ts ${include_dirs[@]} ${lib_dirs[@]} ${libs[@]} ${cpp_files:#src/main.cpp} $tool -o ${tool:t:r}
+done
 echo "Done."
 echo
 
@@ -5,16 +5,38 @@ Boot::Boot() : done(false) {}
 void Boot::finished()
 {
     done = true;
+    if (finish_handler)
+        finish_handler();
 }
 
+bool Boot::is_done() const
+{
+    return done;
+}
+
+// The cartridge header at 0x100-0x1FF stays visible while the boot ROM is mapped
 bool Boot::accepts(const ushort address) const
 {
-    return !done && address < 0x900;
+    return (!done && (address < 0x100 || (address >= 0x200 && address < 0x900))) || address == 0xFF50;
 }
 
 ubyte Boot::read(const ushort address) const
 {
-    return boot_data[address];
+    return (address == 0xFF50) ? 0xFF : boot_data[address];
+}
+
+void Boot::write(const ushort address, const ubyte value)
+{
+    if (address == 0xFF50 && value)
+        finished();
 }
 
-void Boot::write(const ushort address, const ubyte value) {}
\ No newline at end of file
+void Boot::save_state(StateWriter& state) const
+{
+    state.value(done);
+}
+
+void Boot::load_state(StateReader& state)
+{
+    state.value(done);
+}
\ No newline at end of file
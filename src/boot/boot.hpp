@@ -1,8 +1,10 @@
 #pragma once
 
 #include "../memory/memory_unit.hpp"
+#include "../state/state.hpp"
+#include <functional>
 
-class Boot : MemoryUnit
+class Boot : public MemoryUnit
 {
 private:
     const ubyte boot_data[0x900] =
@@ -154,12 +156,19 @@ private:
     };
 
     bool done;
+    std::function<void()> finish_handler;
 
 public:
     Boot();
 
     void finished();
+    // Called when the boot ROM is unmapped
+    void on_finished(std::function<void()> handler) { finish_handler = std::move(handler); }
+    bool is_done() const;
     bool accepts(const ushort address) const override;
     ubyte read(const ushort address) const override;
     void write(const ushort address, const ubyte value) override;
+
+    void save_state(StateWriter& state) const;
+    void load_state(StateReader& state);
 };
\ No newline at end of file
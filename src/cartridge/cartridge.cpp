@@ -1,24 +1,44 @@
 #include "cartridge.hpp"
 
+#include "../utils/hash.hpp"
 #include "../utils/loader.hpp"
-#include <cstring>
 
 Cartridge::Cartridge(const std::string& path)
+    : Cartridge(path, default_save_path(path))
+{}
+
+Cartridge::Cartridge(const std::string& path, const std::string& save_path, const bool host_time)
+    : loaded(false), ram_banks(0), battery(BATTERY_NONE), ram_enabled(false), bank_low(1), bank_high(0), banking_mode(false)
 {
     std::vector<ubyte> file = read_file(path);
 
-    ubyte buffer[16];
-    std::memcpy(&buffer[0], &file[0x134], 16);
-    title = std::string((char*)&buffer[0], 16);
+    header = CartridgeHeader::parse(file.data(), file.size());
 
-    type = static_cast<CartridgeType>(file[0x147]);
+    // A bad size code would have us allocate up to 2 GiB of banks
+    const std::optional<uint> n_banks = header.rom_banks();
+    loaded = !file.empty() && n_banks;
+    if (!loaded)
+    {
+        file.clear();
+        header = CartridgeHeader::parse(file.data(), 0);
+    }
 
-    ubyte rom_size = file[0x148];
-    ubyte n_banks = 2 << (rom_size & 0xF);
-        if (rom_size >> 4) n_banks += 2 << (rom_size >> 4);
-    rom.resize(n_banks);
+    title = header.title;
+    type = header.type;
+    rom = RomStore::instance().acquire(file, n_banks.value_or(2));
+
+    rtc.use_host_time(host_time);
+    build_ram(header.ram_banks(), save_path);
+}
 
-    build_ram(file[0x149]);
+Cartridge::~Cartridge()
+{
+    save_rtc();
+}
+
+void Cartridge::attach(const Scheduler& scheduler)
+{
+    rtc.attach(scheduler);
 }
 
 bool Cartridge::accepts(const ushort addr) const
@@ -31,7 +51,14 @@ ubyte Cartridge::read(const ushort addr) const
     switch (type)
     {
         case ROM_ONLY:      return readRomOnly(addr);
-        case MBC1:          return readMBC1(addr);
+        case MBC1:
+        case MBC1_RAM:
+        case MBC1_RAM_BATT: return readMBC1(addr);
+        case MBC3_TIMER_BATT:
+        case MBC3_TIMER_RAM_BATT:
+        case MBC3:
+        case MBC3_RAM:
+        case MBC3_RAM_BATT: return readMBC3(addr);
         default:            return 0xFF;
     }
 }
@@ -40,31 +67,203 @@ void Cartridge::write(const ushort addr, const ubyte value)
 {
     switch (type)
     {
-        case ROM_ONLY:      writeRomOnly(addr, value);
-        case MBC1:          writeMBC1(addr, value);
+        case ROM_ONLY:      writeRomOnly(addr, value); break;
+        case MBC1:
+        case MBC1_RAM:
+        case MBC1_RAM_BATT: writeMBC1(addr, value); break;
+        case MBC3_TIMER_BATT:
+        case MBC3_TIMER_RAM_BATT:
+        case MBC3:
+        case MBC3_RAM:
+        case MBC3_RAM_BATT: writeMBC3(addr, value); break;
+        default:            break;
     }
 }
 
+ulong Cartridge::rom_hash() const
+{
+    return rom->hash;
+}
+
+// Contents of the RAM banks, without the RTC trailer
+ulong Cartridge::ram_hash() const
+{
+    return hash_bytes(ram.data(), size_t(ram_banks) * 0x2000);
+}
+
+CartridgeRam& Cartridge::battery_ram()
+{
+    return ram;
+}
+
+Rtc& Cartridge::real_time_clock()
+{
+    return rtc;
+}
+
+std::string Cartridge::default_save_path(const std::string& path)
+{
+    const size_t dot = path.find_last_of('.');
+    const size_t slash = path.find_last_of('/');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        return path + ".sav";
+    return path.substr(0, dot) + ".sav";
+}
+
+void Cartridge::save_state(StateWriter& state, const bool with_clock) const
+{
+    state.value(ram_enabled);
+    state.value(bank_low);
+    state.value(bank_high);
+    state.value(banking_mode);
+    state.bytes(ram.data(), size_t(ram_banks) * 0x2000);
+
+    state.value(with_clock);
+    if (with_clock)
+        rtc.save_state(state);
+}
+
+void Cartridge::load_state(StateReader& state)
+{
+    state.value(ram_enabled);
+    state.value(bank_low);
+    state.value(bank_high);
+    state.value(banking_mode);
+
+    const size_t size = size_t(ram_banks) * 0x2000;
+    state.bytes(ram.data(), size);
+    for (size_t offset = 0; offset < size; offset += 0x1000)
+        ram.mark_dirty(offset);
+
+    bool with_clock = false;
+    state.value(with_clock);
+    if (!with_clock)
+        return;
+
+    rtc.load_state(state);
+    save_rtc();
+}
+
 ubyte Cartridge::readRomOnly(const ushort addr) const
 {
-    return (addr < 0x8000) ? rom[0][addr] : 0xFF;
+    if (addr < 0x8000)
+        return rom->banks[(addr >> 14) % rom->banks.size()][addr & 0x3FFF];
+    return 0xFF;
+}
+
+ubyte Cartridge::readMBC1(const ushort addr) const
+{
+    const auto& banks = rom->banks;
+
+    if (addr < 0x4000)
+        return banks[(banking_mode ? bank_high << 5 : 0) % banks.size()][addr];
+
+    if (addr < 0x8000)
+        return banks[(bank_high << 5 | bank_low) % banks.size()][addr & 0x3FFF];
+
+    if (!ram_enabled || !ram_banks)
+        return 0xFF;
+
+    return ram.read(((banking_mode ? bank_high : 0) % ram_banks) << 13 | (addr & 0x1FFF));
 }
 
-ubyte Cartridge::readMBC1(const ushort addr) const { return 0xFF; }
+ubyte Cartridge::readMBC3(const ushort addr) const
+{
+    const auto& banks = rom->banks;
+
+    if (addr < 0x4000)
+        return banks[0][addr];
+
+    if (addr < 0x8000)
+        return banks[bank_low % banks.size()][addr & 0x3FFF];
+
+    if (!ram_enabled)
+        return 0xFF;
+
+    if (bank_high >= Rtc::SECONDS)
+        return header.has_timer() ? rtc.read(bank_high) : 0xFF;
+
+    return ram_banks ? ram.read((bank_high % ram_banks) << 13 | (addr & 0x1FFF)) : 0xFF;
+}
 
 void Cartridge::writeRomOnly(const ushort addr, const ubyte value) {}
 
-void Cartridge::writeMBC1(const ushort addr, const ubyte value) {}
+void Cartridge::writeMBC1(const ushort addr, const ubyte value)
+{
+    switch (addr >> 13)
+    {
+        case 0: ram_enabled = (value & 0xF) == 0xA; break;
+        case 1: bank_low = (value & 0x1F) ? (value & 0x1F) : 1; break;
+        case 2: bank_high = value & 0x3; break;
+        case 3: banking_mode = value & 0x1; break;
+        case 5:
+            if (ram_enabled && ram_banks)
+                ram.write(((banking_mode ? bank_high : 0) % ram_banks) << 13 | (addr & 0x1FFF), value);
+            break;
+        default: break;
+    }
+}
+
+void Cartridge::writeMBC3(const ushort addr, const ubyte value)
+{
+    switch (addr >> 13)
+    {
+        case 0: ram_enabled = (value & 0xF) == 0xA; break;
+        case 1: bank_low = (value & 0x7F) ? (value & 0x7F) : 1; break;
+        case 2: bank_high = value & 0xF; break;
+        case 3: if (header.has_timer()) rtc.write_latch(value); break;
+        case 5:
+            if (!ram_enabled)
+                break;
+
+            if (bank_high >= Rtc::SECONDS)
+            {
+                if (header.has_timer())
+                {
+                    rtc.write(bank_high, value);
+                    save_rtc();
+                }
+            }
+            else if (ram_banks)
+                ram.write((bank_high % ram_banks) << 13 | (addr & 0x1FFF), value);
+            break;
+        default: break;
+    }
+}
 
-void Cartridge::build_ram(ubyte ram_size)
+void Cartridge::build_ram(uint n_banks, const std::string& save_path)
 {
-    switch (ram_size)
+    ram_banks = n_banks;
+
+    // The RTC state is stored as a trailer right after the RAM banks. Saves
+    // without it, or with the older 44-byte one, are grown to the full size
+    const size_t ram_size = size_t(n_banks) * 0x2000;
+    const size_t size = ram_size + (header.has_timer() ? Rtc::trailer_size : 0);
+
+    if (header.has_battery() && !save_path.empty())
     {
-        case 0x0: ram.resize(0); break;
-        case 0x1: ram.resize(1); break;
-        case 0x2: ram.resize(1); break;
-        case 0x3: ram.resize(4); break;
-        case 0x4: ram.resize(16); break;
-        case 0x5: ram.resize(8); break;
+        const bool mapped = header.has_timer() ? ram.map(save_path, size, { ram_size, ram_size + 44 }) : ram.map(save_path, size);
+        if (!mapped)
+            battery = BATTERY_FAILED;
+        else if (ram.persistent())
+            battery = BATTERY_SAVED;
+        else
+            battery = ram.blank() ? BATTERY_BLANK : BATTERY_PRIVATE;
     }
+    else
+        ram.allocate(size);
+
+    if (header.has_timer())
+        rtc.load(ram.data() + size_t(ram_banks) * 0x2000);
+}
+
+void Cartridge::save_rtc()
+{
+    if (!header.has_timer())
+        return;
+
+    const size_t offset = size_t(ram_banks) * 0x2000;
+    rtc.save(ram.data() + offset);
+    ram.mark_dirty(offset);
+    ram.mark_dirty(offset + Rtc::trailer_size - 1);
 }
\ No newline at end of file
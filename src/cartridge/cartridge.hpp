@@ -3,63 +3,83 @@
 #include <types.hpp>
 #include <string>
 #include <memory/memory_unit.hpp>
+#include <cartridge/cartridge_header.hpp>
+#include <cartridge/cartridge_ram.hpp>
+#include <cartridge/rom_store.hpp>
+#include <cartridge/rtc.hpp>
+#include <scheduler/scheduler.hpp>
+#include <memory>
 #include <vector>
 #include <array>
 
-enum CartridgeType
+enum BatteryStatus
 {
-    ROM_ONLY                    = 0x00,
-    MBC1                        = 0x01,
-    MBC1_RAM                    = 0x02,
-    MBC1_RAM_BATT               = 0x03,
-    MBC2                        = 0x05,
-    MBC2_BATT                   = 0x06,
-    ROM_RAM                     = 0x08,
-    ROM_RAM_BATT                = 0x09,
-    MMM01                       = 0x0B,
-    MMM01_RAM                   = 0x0C,
-    MMM01_RAM_BATT              = 0x0D,
-    MBC3_TIMER_BATT             = 0x0F,
-    MBC3_TIMER_RAM_BATT         = 0x10,
-    MBC3                        = 0x11,
-    MBC3_RAM                    = 0x12,
-    MBC3_RAM_BATT               = 0x13,
-    MBC5                        = 0x19,
-    MBC5_RAM                    = 0x1A,
-    MBC5_RAM_BATT               = 0x1B,
-    MBC5_RUMBLE                 = 0x1C,
-    MBC5_RUMBLE_RAM             = 0x1D,
-    MBC5_RUMBLE_RAM_BATT        = 0x1E,
-    MBC6                        = 0x20,
-    MBC7_SENSOR_RUMBLE_RAM_BATT = 0x22,
-    POCKET_CAMERA               = 0xFC,
-    BANDAI_TAMA5                = 0xFD,
-    HuC3                        = 0xFE,
-    HuC1_RAM_BATT               = 0xFF
+    BATTERY_NONE,       // No battery, or no save file asked for
+    BATTERY_SAVED,      // Mapped from the save file
+    BATTERY_PRIVATE,    // Another instance owns the save file; changes are dropped
+    BATTERY_BLANK,      // Another instance is creating the save file; RAM starts blank and changes are dropped
+    BATTERY_FAILED      // The save file could not be used; RAM starts blank
 };
 
-class Cartridge : MemoryUnit
+class Cartridge : public MemoryUnit
 {
 private:
+    CartridgeHeader header;
     std::string title;
     CartridgeType type;
     
-    std::vector<std::array<ubyte, 0x4000>> rom;
-    std::vector<std::array<ubyte, 0x2000>> ram;
+    std::shared_ptr<const Rom> rom;
+    bool loaded;
+    CartridgeRam ram;
+    uint ram_banks;
+    BatteryStatus battery;
+    Rtc rtc;
+
+    // Mapper registers
+    bool ram_enabled;
+    ubyte bank_low;
+    ubyte bank_high;
+    bool banking_mode;
 
 public:
     Cartridge(const std::string& path);
+    // With host time, the MBC3 clock follows the host clock, including the
+    // time spent while the emulator was closed
+    Cartridge(const std::string& path, const std::string& save_path, const bool host_time = false);
+    ~Cartridge();
+
+    void attach(const Scheduler& scheduler);
 
     bool accepts(const ushort addr) const override;
     ubyte read(const ushort addr) const override;
     void write(const ushort addr, const ubyte value) override;
 
+    // False if the file is missing or its header gives no valid ROM size;
+    // the cartridge then reads as an empty slot
+    bool valid() const { return loaded; }
+
+    ulong rom_hash() const;
+    ulong ram_hash() const;
+    bool cgb() const { return header.cgb_flag & 0x80; }
+    CartridgeRam& battery_ram();
+    BatteryStatus battery_status() const { return battery; }
+    Rtc& real_time_clock();
+
+    static std::string default_save_path(const std::string& path);
+
+    // Without the clock, the RTC is left out and keeps running on load
+    void save_state(StateWriter& state, const bool with_clock = true) const;
+    void load_state(StateReader& state);
+
 private:
-    void build_ram(ubyte ram_size);
+    void build_ram(uint n_banks, const std::string& save_path);
+    void save_rtc();
 
     ubyte readRomOnly(const ushort addr) const;
     ubyte readMBC1(const ushort addr) const;
+    ubyte readMBC3(const ushort addr) const;
 
     void writeRomOnly(const ushort addr, const ubyte value);
     void writeMBC1(const ushort addr, const ubyte value);
+    void writeMBC3(const ushort addr, const ubyte value);
 };
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include "cartridge_header.hpp"
+
+#include "../utils/simd_utils.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+CartridgeHeader CartridgeHeader::parse(const ubyte* data, const size_t length)
+{
+    CartridgeHeader header;
+
+    const size_t count = std::min(length, size);
+    std::memcpy(header.raw.data(), data, count);
+    std::fill(header.raw.begin() + count, header.raw.end(), 0);
+
+    const auto& raw = header.raw;
+    const size_t title_length = std::find(&raw[0x134], &raw[0x144], 0) - &raw[0x134];
+    header.title = std::string(reinterpret_cast<const char*>(&raw[0x134]), title_length);
+
+    header.type = static_cast<CartridgeType>(raw[0x147]);
+    header.cgb_flag = raw[0x143];
+    header.rom_size = raw[0x148];
+    header.ram_size = raw[0x149];
+    header.header_checksum = raw[0x14D];
+    header.global_checksum = raw[0x14E] << 8 | raw[0x14F];
+
+    return header;
+}
+
+std::optional<CartridgeHeader> CartridgeHeader::probe(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+
+    ubyte buffer[size];
+    file.read(reinterpret_cast<char*>(buffer), size);
+    if (file.gcount() != size)
+        return std::nullopt;
+
+    return parse(buffer, size);
+}
+
+std::optional<uint> CartridgeHeader::rom_banks() const
+{
+    if (rom_size <= 0x08)
+        return 2u << rom_size;
+
+    switch (rom_size)
+    {
+        case 0x52: return 72;
+        case 0x53: return 80;
+        case 0x54: return 96;
+        default:   return std::nullopt;
+    }
+}
+
+uint CartridgeHeader::ram_banks() const
+{
+    switch (ram_size)
+    {
+        case 0x1: return 1;
+        case 0x2: return 1;
+        case 0x3: return 4;
+        case 0x4: return 16;
+        case 0x5: return 8;
+        default:  return 0;
+    }
+}
+
+bool CartridgeHeader::has_battery() const
+{
+    switch (type)
+    {
+        case MBC1_RAM_BATT:
+        case MBC2_BATT:
+        case ROM_RAM_BATT:
+        case MMM01_RAM_BATT:
+        case MBC3_TIMER_BATT:
+        case MBC3_TIMER_RAM_BATT:
+        case MBC3_RAM_BATT:
+        case MBC5_RAM_BATT:
+        case MBC5_RUMBLE_RAM_BATT:
+        case MBC7_SENSOR_RUMBLE_RAM_BATT:
+        case HuC1_RAM_BATT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool CartridgeHeader::has_timer() const
+{
+    return type == MBC3_TIMER_BATT || type == MBC3_TIMER_RAM_BATT;
+}
+
+bool CartridgeHeader::valid_header_checksum() const
+{
+    ubyte sum = 0;
+    for (size_t i = 0x134; i <= 0x14C; i++)
+        sum = sum - raw[i] - 1;
+    return sum == header_checksum;
+}
+
+bool CartridgeHeader::valid_global_checksum(const std::string& path) const
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+
+    std::vector<ubyte> chunk(0x10000);
+    ulong sum = 0;
+
+    while (file)
+    {
+        file.read(reinterpret_cast<char*>(chunk.data()), chunk.size());
+        sum += sum_bytes(chunk.data(), file.gcount());
+    }
+
+    // The checksum bytes themselves are not part of the sum
+    sum -= raw[0x14E] + raw[0x14F];
+    return ushort(sum) == global_checksum;
+}
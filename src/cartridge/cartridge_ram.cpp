@@ -0,0 +1,109 @@
+#include "cartridge_ram.hpp"
+
+#include <algorithm>
+#include <unistd.h>
+
+CartridgeRam::CartridgeRam()
+    : bytes(nullptr), length(0), page_shift(12), dirty_pages(0), interval(1000), stopping(false)
+{}
+
+CartridgeRam::~CartridgeRam()
+{
+    stop_flusher();
+    flush();
+}
+
+void CartridgeRam::allocate(const size_t size)
+{
+    stop_flusher();
+    file.close();
+
+    memory.assign(size, 0);
+    bytes = memory.data();
+    length = size;
+}
+
+bool CartridgeRam::map(const std::string& path, const size_t size, std::initializer_list<size_t> shorter,
+                       const std::chrono::milliseconds flush_interval)
+{
+    stop_flusher();
+    memory.clear();
+
+    if (size == 0 || !file.open_writable(path, size, shorter))
+    {
+        allocate(size);
+        return false;
+    }
+
+    bytes = file.data();
+    length = size;
+    interval = flush_interval;
+
+    if (!file.is_shared())
+        return true;
+
+    // Dirty pages are tracked in a single 64-bit mask
+    page_shift = 0;
+    while ((1ul << page_shift) < ulong(sysconf(_SC_PAGESIZE)) || (length >> page_shift) >= 64)
+        page_shift++;
+
+    dirty_pages = 0;
+    stopping = false;
+    flusher = std::thread([this] { flush_loop(); });
+    return true;
+}
+
+void CartridgeRam::set_flush_interval(const std::chrono::milliseconds flush_interval)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        interval = flush_interval;
+    }
+    wake.notify_one();
+}
+
+void CartridgeRam::flush()
+{
+    if (!file.is_shared())
+        return;
+
+    ulong pages = dirty_pages.exchange(0, std::memory_order_acquire);
+    while (pages)
+    {
+        const uint first = __builtin_ctzll(pages);
+        uint last = first;
+        while (last + 1 < 64 && (pages >> (last + 1) & 1))
+            last++;
+
+        const size_t offset = size_t(first) << page_shift;
+        const size_t end = std::min(length, size_t(last + 1) << page_shift);
+        file.sync(offset, end - offset);
+
+        pages &= ~((last + 1 < 64 ? (1ull << (last + 1)) : 0) - (1ull << first));
+    }
+}
+
+void CartridgeRam::stop_flusher()
+{
+    if (!flusher.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    flusher.join();
+}
+
+void CartridgeRam::flush_loop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping)
+    {
+        wake.wait_for(lock, interval);
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <types.hpp>
+#include <utils/mapped_file.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// External cartridge RAM. Battery-backed RAM is mapped from its .sav file;
+// writes mark host pages dirty and a background thread syncs them to disk
+// every flush interval, so the emulation thread never waits on I/O. When
+// another instance already has the file mapped, this one works on a
+// private copy that is never written back.
+class CartridgeRam
+{
+private:
+    std::vector<ubyte> memory;
+    MappedFile file;
+    ubyte* bytes;
+    size_t length;
+
+    uint page_shift;
+    std::atomic<ulong> dirty_pages;
+
+    std::chrono::milliseconds interval;
+    std::thread flusher;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping;
+
+public:
+    CartridgeRam();
+    CartridgeRam(const CartridgeRam&) = delete;
+    CartridgeRam& operator=(const CartridgeRam&) = delete;
+    ~CartridgeRam();
+
+    void allocate(const size_t size);
+    bool map(const std::string& path, const size_t size, std::initializer_list<size_t> shorter = {},
+             const std::chrono::milliseconds flush_interval = std::chrono::milliseconds(1000));
+
+    void set_flush_interval(const std::chrono::milliseconds flush_interval);
+    void flush();
+
+    bool persistent() const { return file.is_shared(); }
+    bool blank() const { return file.is_blank(); }
+    bool empty() const { return length == 0; }
+    size_t size() const { return length; }
+    ubyte* data() { return bytes; }
+    const ubyte* data() const { return bytes; }
+
+    ubyte read(const size_t offset) const { return bytes[offset]; }
+
+    void write(const size_t offset, const ubyte value)
+    {
+        bytes[offset] = value;
+        mark_dirty(offset);
+    }
+
+    void mark_dirty(const size_t offset)
+    {
+        const ulong bit = 1ull << (offset >> page_shift);
+        if (!(dirty_pages.load(std::memory_order_relaxed) & bit))
+            dirty_pages.fetch_or(bit, std::memory_order_relaxed);
+    }
+
+private:
+    void stop_flusher();
+    void flush_loop();
+};
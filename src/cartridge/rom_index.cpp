@@ -0,0 +1,183 @@
+#include "rom_index.hpp"
+
+#include "../utils/hash.hpp"
+#include "../utils/loader.hpp"
+#include "../utils/thread_pool.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+
+namespace
+{
+    constexpr char index_magic[4] = { 'G', 'B', 'I', 'X' };
+    constexpr uint index_version = 1;
+
+    bool is_rom(const std::filesystem::path& path)
+    {
+        std::string ext = path.extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+        return ext == ".gb" || ext == ".gbc" || ext == ".cgb";
+    }
+
+    void index_rom(const std::string& path, const size_t number, std::vector<RomIndexEntry>& records, std::mutex& records_mutex)
+    {
+        const std::vector<ubyte> contents = read_file(path);
+        if (contents.size() < CartridgeHeader::size)
+            throw std::runtime_error("unreadable or shorter than a cartridge header");
+
+        const CartridgeHeader header = CartridgeHeader::parse(contents.data(), contents.size());
+
+        // Same sizes Cartridge would refuse to load
+        if (!header.rom_banks())
+            throw std::runtime_error("invalid ROM size code");
+        if (header.ram_size > 0x05)
+            throw std::runtime_error("invalid RAM size code");
+
+        RomIndexEntry entry{};
+        entry.hash = hash_bytes(contents.data(), contents.size());
+        entry.file_size = contents.size();
+        entry.path_offset = number;
+        std::memcpy(entry.title, header.title.data(), std::min<size_t>(header.title.size(), sizeof(entry.title)));
+        entry.type = header.type;
+        entry.cgb_flag = header.cgb_flag;
+        entry.rom_size = header.rom_size;
+        entry.ram_size = header.ram_size;
+
+        std::lock_guard<std::mutex> lock(records_mutex);
+        records.push_back(entry);
+    }
+}
+
+RomIndex::RomIndex() : entries(nullptr), n_entries(0), strings(nullptr) {}
+
+bool RomIndex::build(const std::vector<std::string>& dirs, const std::string& index_path, const unsigned n_threads,
+                     std::vector<std::string>* errors)
+{
+    std::vector<std::string> paths;
+    for (const auto& dir : dirs)
+    {
+        std::error_code ec;
+        for (auto it = std::filesystem::recursive_directory_iterator(dir, ec); !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec))
+        {
+            // An entry that cannot be inspected is skipped, not the rest of the walk
+            std::error_code file_ec;
+            if (it->is_regular_file(file_ec) && is_rom(it->path()))
+                paths.push_back(it->path().string());
+        }
+    }
+
+    std::vector<RomIndexEntry> records;
+    std::mutex records_mutex;
+
+    {
+        ThreadPool pool(n_threads ? n_threads : std::thread::hardware_concurrency());
+
+        for (size_t i = 0; i < paths.size(); i++)
+        {
+            pool.submit([&, i]
+            {
+                // An exception escaping a job would end the whole process
+                try
+                {
+                    index_rom(paths[i], i, records, records_mutex);
+                }
+                catch (const std::exception& e)
+                {
+                    std::lock_guard<std::mutex> lock(records_mutex);
+                    if (errors)
+                        errors->push_back(paths[i] + ": " + e.what());
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(records_mutex);
+                    if (errors)
+                        errors->push_back(paths[i] + ": unknown error");
+                }
+            });
+        }
+
+        pool.wait();
+    }
+
+    std::sort(records.begin(), records.end(), [](const auto& a, const auto& b) { return a.hash < b.hash; });
+
+    // Path offsets hold the path number until the string table is laid out
+    std::string table;
+    for (auto& entry : records)
+    {
+        const std::string& path = paths[entry.path_offset];
+        entry.path_offset = table.size();
+        entry.path_length = path.size();
+        table += path;
+    }
+
+    RomIndexHeader header{};
+    std::memcpy(header.magic, index_magic, sizeof(index_magic));
+    header.version = index_version;
+    header.n_entries = records.size();
+    header.strings_offset = sizeof(RomIndexHeader) + records.size() * sizeof(RomIndexEntry);
+    header.strings_size = table.size();
+
+    const std::string tmp_path = temp_path(index_path);
+    std::error_code ec;
+    {
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(RomIndexEntry));
+        out.write(table.data(), table.size());
+        if (!out)
+        {
+            std::filesystem::remove(tmp_path, ec);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tmp_path, index_path, ec);
+    if (!ec)
+        return true;
+
+    std::filesystem::remove(tmp_path, ec);
+    return false;
+}
+
+bool RomIndex::open(const std::string& index_path)
+{
+    entries = nullptr;
+    n_entries = 0;
+    strings = nullptr;
+
+    if (!file.open(index_path) || file.size() < sizeof(RomIndexHeader))
+        return false;
+
+    // Counts are checked against the file size before any offset is
+    // computed from them, so a corrupt header cannot wrap around
+    const auto* header = reinterpret_cast<const RomIndexHeader*>(file.data());
+    if (std::memcmp(header->magic, index_magic, sizeof(index_magic)) != 0 || header->version != index_version
+        || header->n_entries > (file.size() - sizeof(RomIndexHeader)) / sizeof(RomIndexEntry)
+        || header->strings_offset != sizeof(RomIndexHeader) + header->n_entries * sizeof(RomIndexEntry)
+        || header->strings_size > file.size() - header->strings_offset)
+    {
+        file.close();
+        return false;
+    }
+
+    entries = reinterpret_cast<const RomIndexEntry*>(file.data() + sizeof(RomIndexHeader));
+    n_entries = header->n_entries;
+    strings = reinterpret_cast<const char*>(file.data() + header->strings_offset);
+    return true;
+}
+
+const RomIndexEntry* RomIndex::find(const ulong hash) const
+{
+    const RomIndexEntry* it = std::lower_bound(begin(), end(), hash, [](const auto& entry, const ulong h) { return entry.hash < h; });
+    return (it != end() && it->hash == hash) ? it : nullptr;
+}
+
+std::string_view RomIndex::path(const RomIndexEntry& entry) const
+{
+    return std::string_view(strings + entry.path_offset, entry.path_length);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <types.hpp>
+#include <cartridge/cartridge_header.hpp>
+#include <utils/mapped_file.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Fixed-size record of the index file. Records are sorted by hash.
+struct RomIndexEntry
+{
+    ulong hash;
+    ulong file_size;
+    uint path_offset;
+    uint path_length;
+    char title[16];
+    ubyte type;
+    ubyte cgb_flag;
+    ubyte rom_size;
+    ubyte ram_size;
+    ubyte padding[20];
+};
+static_assert(sizeof(RomIndexEntry) == 64);
+
+struct RomIndexHeader
+{
+    char magic[4];
+    uint version;
+    ulong n_entries;
+    ulong strings_offset;
+    ulong strings_size;
+};
+static_assert(sizeof(RomIndexHeader) == 32);
+
+// Index of a ROM library. The file is a header, the sorted entry table and
+// a string table with the paths, so it can be mapped and searched in place.
+class RomIndex
+{
+private:
+    MappedFile file;
+    const RomIndexEntry* entries;
+    size_t n_entries;
+    const char* strings;
+
+public:
+    RomIndex();
+
+    // ROMs that fail to be read are left out and, if `errors` is given,
+    // reported there as "path: reason"
+    static bool build(const std::vector<std::string>& dirs, const std::string& index_path, const unsigned n_threads = 0,
+                      std::vector<std::string>* errors = nullptr);
+
+    bool open(const std::string& index_path);
+
+    size_t size() const { return n_entries; }
+    const RomIndexEntry* begin() const { return entries; }
+    const RomIndexEntry* end() const { return entries + n_entries; }
+
+    const RomIndexEntry* find(const ulong hash) const;
+    std::string_view path(const RomIndexEntry& entry) const;
+};
@@ -0,0 +1,63 @@
+#include "rom_store.hpp"
+
+#include "../utils/hash.hpp"
+#include <algorithm>
+#include <cstring>
+
+RomStore& RomStore::instance()
+{
+    static RomStore store;
+    return store;
+}
+
+std::shared_ptr<const Rom> RomStore::acquire(const std::vector<ubyte>& file, const uint n_banks)
+{
+    const ulong hash = hash_bytes(file.data(), file.size());
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (auto it = roms.find(hash); it != roms.end())
+    {
+        if (auto rom = it->second.lock(); rom && same_contents(*rom, file, n_banks))
+            return rom;
+    }
+
+    auto rom = std::make_shared<Rom>();
+    rom->hash = hash;
+    rom->banks.resize(n_banks);
+
+    for (uint i = 0; i < n_banks; i++)
+    {
+        const size_t offset = size_t(i) * 0x4000;
+        const size_t count = offset < file.size() ? std::min<size_t>(0x4000, file.size() - offset) : 0;
+
+        std::memcpy(rom->banks[i].data(), file.data() + offset, count);
+        std::fill(rom->banks[i].begin() + count, rom->banks[i].end(), 0xFF);
+    }
+
+    for (auto it = roms.begin(); it != roms.end();)
+        it = it->second.expired() ? roms.erase(it) : std::next(it);
+
+    roms[hash] = rom;
+    return rom;
+}
+
+size_t RomStore::size()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::count_if(roms.begin(), roms.end(), [](const auto& entry) { return !entry.second.expired(); });
+}
+
+bool RomStore::same_contents(const Rom& rom, const std::vector<ubyte>& file, const uint n_banks)
+{
+    if (rom.banks.size() != n_banks)
+        return false;
+
+    for (size_t offset = 0; offset < file.size() && offset / 0x4000 < n_banks; offset += 0x4000)
+    {
+        const size_t count = std::min<size_t>(0x4000, file.size() - offset);
+        if (std::memcmp(rom.banks[offset / 0x4000].data(), file.data() + offset, count) != 0)
+            return false;
+    }
+    return true;
+}
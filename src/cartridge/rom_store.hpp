@@ -0,0 +1,38 @@
+#pragma once
+
+#include <types.hpp>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Read-only ROM image, shared by every cartridge loaded from the same contents.
+struct Rom
+{
+    ulong hash;
+    std::vector<std::array<ubyte, 0x4000>> banks;
+};
+
+// Process-wide registry of ROM images keyed by content hash. Images are
+// reference counted and released once the last cartridge using them goes away.
+class RomStore
+{
+private:
+    std::mutex mutex;
+    std::unordered_map<ulong, std::weak_ptr<const Rom>> roms;
+
+    RomStore() = default;
+
+public:
+    RomStore(const RomStore&) = delete;
+    RomStore& operator=(const RomStore&) = delete;
+
+    static RomStore& instance();
+
+    std::shared_ptr<const Rom> acquire(const std::vector<ubyte>& file, const uint n_banks);
+    size_t size();
+
+private:
+    static bool same_contents(const Rom& rom, const std::vector<ubyte>& file, const uint n_banks);
+};
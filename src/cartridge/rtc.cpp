@@ -0,0 +1,206 @@
+#include "rtc.hpp"
+
+#include <chrono>
+#include <cstring>
+
+namespace
+{
+    constexpr ulong second = Scheduler::frequency;
+    constexpr ulong day = 86400;
+    constexpr ulong wrap = 512 * day;
+
+    void put32(ubyte* dest, const uint value)
+    {
+        for (int i = 0; i < 4; i++)
+            dest[i] = value >> (i * 8);
+    }
+
+    ulong get(const ubyte* src, const int n)
+    {
+        ulong value = 0;
+        for (int i = 0; i < n; i++)
+            value |= ulong(src[i]) << (i * 8);
+        return value;
+    }
+
+    ulong unix_time()
+    {
+        return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+}
+
+Rtc::Rtc()
+    : scheduler(nullptr), host_time(false), base_counter(0), base_timestamp(0),
+      halted(false), carry(false), offline_since(0), latched{}, latch_state(0xFF)
+{}
+
+void Rtc::attach(const Scheduler& scheduler)
+{
+    const ulong current = counter();
+    this->scheduler = &scheduler;
+    rebase(current);
+}
+
+void Rtc::use_host_time(const bool enabled)
+{
+    const ulong current = counter();
+    host_time = enabled;
+    rebase(current);
+
+    if (host_time)
+        catch_up_offline();
+}
+
+void Rtc::write_latch(const ubyte value)
+{
+    if (latch_state == 0x00 && value == 0x01)
+        registers(latched);
+    latch_state = value;
+}
+
+ubyte Rtc::read(const ubyte reg) const
+{
+    switch (reg)
+    {
+        case SECONDS:  return latched[0];
+        case MINUTES:  return latched[1];
+        case HOURS:    return latched[2];
+        case DAY_LOW:  return latched[3];
+        case DAY_HIGH: return latched[4];
+        default:       return 0xFF;
+    }
+}
+
+void Rtc::write(const ubyte reg, const ubyte value)
+{
+    ubyte regs[5];
+    registers(regs);
+
+    ulong subsecond = counter() % second;
+
+    switch (reg)
+    {
+        case SECONDS:  regs[0] = value & 0x3F; subsecond = 0; break;
+        case MINUTES:  regs[1] = value & 0x3F; break;
+        case HOURS:    regs[2] = value & 0x1F; break;
+        case DAY_LOW:  regs[3] = value; break;
+        case DAY_HIGH: regs[4] = value & 0xC1; break;
+        default:       return;
+    }
+
+    const ulong days = (regs[4] & 0x1) << 8 | regs[3];
+    const ulong seconds = days * day + regs[2] * 3600ul + regs[1] * 60ul + regs[0];
+
+    carry = regs[4] & 0x80;
+    halted = regs[4] & 0x40;
+    rebase(seconds * second + subsecond);
+}
+
+// Trailer layout shared with other emulators: current S, M, H, DL, DH,
+// latched S, M, H, DL, DH as 32-bit words, then a 64-bit UNIX timestamp.
+void Rtc::save(ubyte* trailer) const
+{
+    ubyte regs[5];
+    registers(regs);
+
+    for (int i = 0; i < 5; i++)
+    {
+        put32(trailer + i * 4, regs[i]);
+        put32(trailer + 20 + i * 4, latched[i]);
+    }
+
+    const ulong now = unix_time();
+    put32(trailer + 40, now);
+    put32(trailer + 44, now >> 32);
+}
+
+void Rtc::load(const ubyte* trailer)
+{
+    ubyte regs[5];
+    for (int i = 0; i < 5; i++)
+    {
+        regs[i] = get(trailer + i * 4, 1);
+        latched[i] = get(trailer + 20 + i * 4, 1);
+    }
+
+    const ulong days = (regs[4] & 0x1) << 8 | regs[3];
+    ulong seconds = days * day + (regs[2] % 24) * 3600ul + (regs[1] % 60) * 60ul + (regs[0] % 60);
+
+    carry = regs[4] & 0x80;
+    halted = regs[4] & 0x40;
+
+    rebase(seconds * second);
+
+    // Host time keeps running while the emulator is closed
+    offline_since = get(trailer + 40, 8);
+    if (host_time)
+        catch_up_offline();
+}
+
+ulong Rtc::timestamp() const
+{
+    if (host_time)
+    {
+        const ulong now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        return now / 1000000 * second + now % 1000000 * second / 1000000;
+    }
+    return scheduler ? scheduler->now() : 0;
+}
+
+ulong Rtc::counter() const
+{
+    return halted ? base_counter : base_counter + (timestamp() - base_timestamp);
+}
+
+void Rtc::registers(ubyte* regs) const
+{
+    const ulong seconds = counter() / second;
+    const ulong days = seconds / day;
+
+    regs[0] = seconds % 60;
+    regs[1] = seconds / 60 % 60;
+    regs[2] = seconds / 3600 % 24;
+    regs[3] = days & 0xFF;
+    regs[4] = (days >> 8 & 0x1) | (halted ? 0x40 : 0) | ((carry || days >= 512) ? 0x80 : 0);
+}
+
+void Rtc::rebase(const ulong counter)
+{
+    base_counter = counter;
+    base_timestamp = timestamp();
+}
+
+void Rtc::catch_up_offline()
+{
+    const ulong now = unix_time();
+    ulong current = counter();
+
+    if (offline_since && !halted && offline_since < now)
+        current += (now - offline_since) * second;
+    offline_since = 0;
+
+    if (current >= wrap * second)
+        carry = true;
+    rebase(current % (wrap * second));
+}
+
+
+void Rtc::save_state(StateWriter& state) const
+{
+    state.value(base_counter);
+    state.value(base_timestamp);
+    state.value(halted);
+    state.value(carry);
+    state.value(latched);
+    state.value(latch_state);
+}
+
+void Rtc::load_state(StateReader& state)
+{
+    state.value(base_counter);
+    state.value(base_timestamp);
+    state.value(halted);
+    state.value(carry);
+    state.value(latched);
+    state.value(latch_state);
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <types.hpp>
+#include <scheduler/scheduler.hpp>
+#include <state/state.hpp>
+#include <cstddef>
+
+// MBC3 real-time clock. Nothing ticks: the counter is kept as a base value
+// at a base timestamp, and the registers are derived from the time elapsed
+// since then whenever they are latched or written. Time comes from the
+// emulated master clock, or from the host clock when requested.
+class Rtc
+{
+public:
+    enum Register : ubyte
+    {
+        SECONDS = 0x08,
+        MINUTES = 0x09,
+        HOURS   = 0x0A,
+        DAY_LOW = 0x0B,
+        DAY_HIGH= 0x0C
+    };
+
+    static constexpr size_t trailer_size = 48;
+
+private:
+    const Scheduler* scheduler;
+    bool host_time;
+
+    ulong base_counter;     // In master clock cycles
+    ulong base_timestamp;   // Clock value when base_counter was taken
+    bool halted;
+    bool carry;
+    ulong offline_since;    // UNIX time the loaded trailer was saved at, until caught up
+
+    ubyte latched[5];
+    ubyte latch_state;
+
+public:
+    Rtc();
+
+    void attach(const Scheduler& scheduler);
+    // Enabling host time also adds the time spent since the trailer was saved
+    void use_host_time(const bool enabled);
+
+    void write_latch(const ubyte value);
+    ubyte read(const ubyte reg) const;
+    void write(const ubyte reg, const ubyte value);
+
+    void save(ubyte* trailer) const;
+    void load(const ubyte* trailer);
+
+    void save_state(StateWriter& state) const;
+    void load_state(StateReader& state);
+
+private:
+    ulong timestamp() const;
+    ulong counter() const;
+    void registers(ubyte* regs) const;
+    void rebase(const ulong counter);
+    void catch_up_offline();
+};
@@ -3,8 +3,8 @@
 #include <iostream>
 using namespace std::experimental;
 
-CPU::CPU(MMU& mmu, Interrupts& irq)
-    : mmu(mmu), irq(irq), cyclesLeft(0), stopped(false), halted(false), haltBug(false)
+CPU::CPU(MMU& mmu, Interrupts& irq, Scheduler& scheduler)
+    : mmu(mmu), irq(irq), scheduler(scheduler), cyclesLeft(0), stopped(false), halted(false), haltBug(false), stalled(0)
 {
     regs.AF = 0x11B0;
     regs.BC = 0x0013;
@@ -13,10 +13,22 @@ CPU::CPU(MMU& mmu, Interrupts& irq)
 
     regs.PC = 0x0100;
     regs.SP = 0xFFFE;
+
+    scheduler.on(SPEED_SWITCH, [this](ulong)
+    {
+        stalled &= ~STALL_SPEED_SWITCH;
+        if (stop_handler)
+            stop_handler();
+    });
 }
 
 void CPU::execute()
 {
+    scheduler.tick(4);
+
+    if (stalled || stopped)
+        return;
+
     if (!cyclesLeft) { // Check interrupts and fetch a new instruction
         if (irq.IME) {
             if (halted) {
@@ -54,6 +66,27 @@ void CPU::execute()
     instruction();
 }
 
+void CPU::save_state(StateWriter& state) const
+{
+    state.value(regs);
+    state.value(stopped);
+    state.value(halted);
+    state.value(haltBug);
+    state.value(stalled);
+}
+
+void CPU::load_state(StateReader& state)
+{
+    state.value(regs);
+    state.value(stopped);
+    state.value(halted);
+    state.value(haltBug);
+    state.value(stalled);
+
+    cyclesLeft = 0;
+    instruction = Task();
+}
+
 void CPU::fetchOpcode()
 {
     static bool debug = false;
@@ -445,7 +478,19 @@ Task CPU::rrca()
 // 0x1X
 Task CPU::stop()
 {
-    stopped = true;
+	if (stop_handler)
+		stop_handler();
+
+	if (scheduler.speed_switch_armed())
+	{
+		// The CPU clock halts for 2050 M-cycles while the speed changes
+		scheduler.switch_speed();
+		stalled |= STALL_SPEED_SWITCH;
+		scheduler.schedule_cpu(SPEED_SWITCH, scheduler.cpu_now() + 2050 * 4);
+	}
+	else
+		stopped = true;
+
 	co_return;
 }
 
@@ -5,11 +5,23 @@
 #include "registers.hpp"
 
 #include "../memory/mmu.hpp"
+#include "../scheduler/scheduler.hpp"
+#include "../state/state.hpp"
+
+#include <functional>
+
+// Units that can hold the CPU clock; each releases only its own stall
+enum StallSource : ubyte
+{
+	STALL_SPEED_SWITCH = 0x1,
+	STALL_DMA = 0x2
+};
 
 struct CPU
 {
     MMU& mmu;
 	Interrupts& irq;
+	Scheduler& scheduler;
     Registers regs;
 	Task instruction;
 
@@ -17,10 +29,20 @@ struct CPU
 	bool stopped;
 	bool halted;
 	bool haltBug;
+	ubyte stalled;	// StallSource bits
+	std::function<void()> stop_handler;
 
-    CPU(MMU& mmu, Interrupts& irq);
+    CPU(MMU& mmu, Interrupts& irq, Scheduler& scheduler);
 	void execute();
 
+	// Called on every STOP, and again when a speed switch lets the clock
+	// run, since the divider is held at zero until then
+	void on_stop(std::function<void()> handler) { stop_handler = std::move(handler); }
+
+	// Only valid between instructions, when cyclesLeft is 0
+	void save_state(StateWriter& state) const;
+	void load_state(StateReader& state);
+
 private:
 	void fetchOpcode();
 	Task interruptCallback();
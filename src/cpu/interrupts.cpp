@@ -51,4 +51,24 @@ void Interrupts::write(const ushort address, const ubyte value)
 ubyte Interrupts::read(const ushort address) const
 {
     return (address == 0xFF0F) ? IF : IE;
+}
+
+void Interrupts::save_state(StateWriter& state) const
+{
+    state.value(IME);
+    state.value(delay);
+    state.value(maybeModified);
+    state.value(vector);
+    state.value(IF);
+    state.value(IE);
+}
+
+void Interrupts::load_state(StateReader& state)
+{
+    state.value(IME);
+    state.value(delay);
+    state.value(maybeModified);
+    state.value(vector);
+    state.value(IF);
+    state.value(IE);
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../memory/memory_unit.hpp"
+#include "../state/state.hpp"
 
 class Interrupts : public MemoryUnit
 {
@@ -39,6 +40,9 @@ public:
 	void write(const ushort address, ubyte value) override;
 	ubyte read(const ushort address) const override;
 
+	void save_state(StateWriter& state) const;
+	void load_state(StateReader& state);
+
 private:
 	uint many_bits(const ubyte b)
 	{
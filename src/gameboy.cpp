@@ -0,0 +1,275 @@
+#include "gameboy.hpp"
+
+#include "state/snapshot.hpp"
+#include <cstdio>
+#include <filesystem>
+
+GameBoy::GameBoy(const std::string& rom_path, const GameBoyOptions& options)
+    : speed_switch(scheduler),
+      cartridge(rom_path, options.battery ? Cartridge::default_save_path(rom_path) : "", options.host_rtc),
+      wram(mmu), vram(mmu), timer(scheduler, irq), serial(scheduler, irq), cpu(mmu, irq, scheduler), dma(mmu, oam, scheduler, cpu),
+      joypad(scheduler, irq, cpu), ppu(scheduler, irq, dma, vram, oam, cartridge.cgb(), options.renderer, options.render_interval)
+{
+    cartridge.attach(scheduler);
+    boot.on_finished([this] { update_cgb_mode(); });
+    cpu.on_stop([this] { timer.reset_divider(); });
+    update_cgb_mode();
+
+    mmu.load(&boot);
+    mmu.load(&joypad);
+    mmu.load(&cartridge);
+    mmu.load(&wram);
+    mmu.load(&vram);
+    mmu.load(&oam);
+    mmu.load(&hram);
+    mmu.load(&timer);
+    mmu.load(&serial);
+    mmu.load(&ppu);
+    mmu.load(&dma);
+    mmu.load(&speed_switch);
+    mmu.load(&irq);
+
+    switch (options.boot)
+    {
+        case BootMode::SKIP:
+            boot.finished();
+            break;
+
+        case BootMode::BOOT_ROM:
+            start_boot_rom();
+            break;
+
+        case BootMode::FAST_BOOT:
+            if (!fast_boot(rom_path, options))
+                boot.finished();
+            break;
+    }
+
+    if (options.warm_start)
+        warm_status = warm_start(rom_path, options);
+}
+
+// The boot ROM runs in CGB mode; a DMG cartridge then loses the CGB registers
+void GameBoy::update_cgb_mode()
+{
+    const bool cgb_mode = cartridge.cgb() || !boot.is_done();
+    speed_switch.set_cgb_mode(cgb_mode);
+    wram.set_cgb_mode(cgb_mode);
+    vram.set_cgb_mode(cgb_mode);
+    serial.set_cgb_mode(cgb_mode);
+}
+
+void GameBoy::step()
+{
+    cpu.execute();
+}
+
+void GameBoy::finish_instruction()
+{
+    while (cpu.cyclesLeft)
+        step();
+}
+
+void GameBoy::run_until(const ulong cycles)
+{
+    joypad.poll();
+
+    while (scheduler.now() < cycles)
+        step();
+}
+
+std::vector<ubyte> GameBoy::save_state(const bool with_cartridge, const bool with_clock) const
+{
+    std::vector<ubyte> res;
+    StateWriter state(res);
+
+    scheduler.save_state(state);
+    cpu.save_state(state);
+    irq.save_state(state);
+    boot.save_state(state);
+    wram.save_state(state);
+    vram.save_state(state);
+    oam.save_state(state);
+    hram.save_state(state);
+    timer.save_state(state);
+    serial.save_state(state);
+    dma.save_state(state);
+    joypad.save_state(state);
+    ppu.save_state(state);
+
+    state.value(with_cartridge);
+    if (with_cartridge)
+        cartridge.save_state(state, with_clock);
+
+    return res;
+}
+
+// Units are overwritten one by one, so a state that turns out to be bad is
+// rolled back to the one taken before
+bool GameBoy::load_state(const ubyte* data, const size_t size)
+{
+    const std::vector<ubyte> previous = save_state();
+    if (restore_state(data, size))
+        return true;
+
+    restore_state(previous.data(), previous.size());
+    return false;
+}
+
+bool GameBoy::restore_state(const ubyte* data, const size_t size)
+{
+    StateReader state(data, size);
+
+    scheduler.load_state(state);
+    cpu.load_state(state);
+    irq.load_state(state);
+    boot.load_state(state);
+    update_cgb_mode();
+    wram.load_state(state);
+    vram.load_state(state);
+    oam.load_state(state);
+    hram.load_state(state);
+    timer.load_state(state);
+    serial.load_state(state);
+    dma.load_state(state);
+    joypad.load_state(state);
+    ppu.load_state(state);
+
+    bool with_cartridge = false;
+    state.value(with_cartridge);
+    if (with_cartridge)
+        cartridge.load_state(state);
+
+    return state.done();
+}
+
+std::string GameBoy::cache_path(const std::string& cache_dir, const std::string& extension) const
+{
+    const std::filesystem::path dir = cache_dir.empty() ? std::filesystem::temp_directory_path() / "gameboy-cache" : std::filesystem::path(cache_dir);
+
+    char name[24];
+    std::snprintf(name, sizeof(name), "%016llX.", (unsigned long long)cartridge.rom_hash());
+    return (dir / (name + extension)).string();
+}
+
+void GameBoy::start_boot_rom()
+{
+    cpu.regs = Registers{};
+    cpu.regs.PC = 0x0000;
+}
+
+// The post-boot state only depends on the cartridge, so it is produced once
+// by running the boot ROM on a scratch machine and cached under the ROM hash.
+// A boot that never completes is cached too, as an empty snapshot.
+bool GameBoy::fast_boot(const std::string& rom_path, const GameBoyOptions& options)
+{
+    const std::string path = cache_path(options.cache_dir, "boot");
+
+    Snapshot snapshot;
+    if (!snapshot.open(path, SNAPSHOT_BOOT, cartridge.rom_hash()))
+    {
+        GameBoyOptions boot_options = options;
+        boot_options.boot = BootMode::BOOT_ROM;
+        boot_options.battery = false;
+        boot_options.render_interval = 0;
+
+        GameBoy reference(rom_path, boot_options);
+        while (!reference.boot.is_done() && reference.scheduler.now() < boot_timeout)
+            reference.step();
+
+        std::vector<ubyte> state;
+        if (reference.boot.is_done())
+        {
+            reference.finish_instruction();
+            state = reference.save_state(false);
+        }
+
+        if (!Snapshot::write(path, SNAPSHOT_BOOT, cartridge.rom_hash(), state)
+            || !snapshot.open(path, SNAPSHOT_BOOT, cartridge.rom_hash()))
+            return false;
+    }
+
+    if (snapshot.empty())
+        return false;
+
+    if (load_state(snapshot.data(), snapshot.size()))
+        return true;
+
+    // Unreadable despite a matching header; let the next instance rebuild it
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    return false;
+}
+
+
+// Warm-start snapshots are keyed by ROM hash, every option that shapes the
+// saved state, the contents of the save and the start point, and restored
+// straight from the mapped file. They are made on a scratch machine that
+// runs on a copy of the save, so neither a start point that is never
+// reached nor the run up to it touches this machine or the save file; an
+// unreachable point is cached as an empty snapshot.
+WarmStartStatus GameBoy::warm_start(const std::string& rom_path, const GameBoyOptions& options)
+{
+    const WarmStartPoint& point = *options.warm_start;
+
+    char key[96];
+    const int length = std::snprintf(key, sizeof(key), "warm%d-r%d-t%d-%016llX", int(options.boot), int(options.renderer),
+                                     int(options.host_rtc), (unsigned long long)cartridge.ram_hash());
+    if (point.pc)
+        std::snprintf(key + length, sizeof(key) - length, "-pc%04X", *point.pc);
+    else
+        std::snprintf(key + length, sizeof(key) - length, "-f%llu", (unsigned long long)point.frame);
+
+    const std::string path = cache_path(options.cache_dir, key);
+
+    Snapshot snapshot;
+    if (!snapshot.open(path, SNAPSHOT_WARM, cartridge.rom_hash()))
+    {
+        GameBoyOptions scratch_options = options;
+        scratch_options.battery = false;
+        scratch_options.render_interval = 0;
+        scratch_options.warm_start.reset();
+
+        GameBoy scratch(rom_path, scratch_options);
+
+        std::vector<ubyte> save;
+        StateWriter save_writer(save);
+        cartridge.save_state(save_writer);
+        StateReader save_reader(save.data(), save.size());
+        scratch.cartridge.load_state(save_reader);
+
+        bool reached = true;
+        if (point.pc)
+        {
+            while (scratch.cpu.cyclesLeft || scratch.cpu.regs.PC != *point.pc)
+            {
+                if (scratch.scheduler.now() >= warm_start_timeout)
+                {
+                    reached = false;
+                    break;
+                }
+                scratch.step();
+            }
+        }
+        else
+        {
+            scratch.run_until(point.frame * frame_cycles);
+            scratch.finish_instruction();
+        }
+
+        const std::vector<ubyte> state = reached ? scratch.save_state(true, false) : std::vector<ubyte>();
+        if (!Snapshot::write(path, SNAPSHOT_WARM, cartridge.rom_hash(), state)
+            || !snapshot.open(path, SNAPSHOT_WARM, cartridge.rom_hash()))
+            return WARM_START_FAILED;
+    }
+
+    if (snapshot.empty())
+        return WARM_START_UNREACHED;
+
+    if (load_state(snapshot.data(), snapshot.size()))
+        return WARM_START_RESTORED;
+
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    return WARM_START_FAILED;
+}
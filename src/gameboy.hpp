@@ -0,0 +1,115 @@
+#pragma once
+
+#include "boot/boot.hpp"
+#include "cartridge/cartridge.hpp"
+#include "cpu/cpu.hpp"
+#include "cpu/interrupts.hpp"
+#include "joypad/joypad.hpp"
+#include "memory/dma.hpp"
+#include "memory/high_ram.hpp"
+#include "memory/mmu.hpp"
+#include "memory/oam.hpp"
+#include "memory/video_ram.hpp"
+#include "memory/work_ram.hpp"
+#include "ppu/ppu.hpp"
+#include "scheduler/scheduler.hpp"
+#include "scheduler/speed_switch.hpp"
+#include "serial/serial.hpp"
+#include "timer/timer.hpp"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+enum class BootMode
+{
+    SKIP,       // Start at 0x100 with the post-boot CPU registers
+    BOOT_ROM,   // Run the CGB boot ROM
+    FAST_BOOT   // Restore the post-boot state cached for the cartridge
+};
+
+// Point at which a warm-start snapshot is taken: the first instruction at
+// pc if set, otherwise the start of the given frame.
+struct WarmStartPoint
+{
+    ulong frame{ 0 };
+    std::optional<ushort> pc;
+};
+
+struct GameBoyOptions
+{
+    BootMode boot{ BootMode::SKIP };
+    std::string cache_dir;      // Defaults to a directory under the system temp dir
+    bool battery{ true };       // Persist battery RAM next to the ROM; see Cartridge::battery_status
+    bool host_rtc{ false };     // MBC3 clock runs on host time, also while closed
+    Renderer renderer{ Renderer::SCANLINE };
+    uint render_interval{ 1 };  // Draw one frame in this many, none for 0
+
+    // Restore the machine at this point from the cache, or run a scratch
+    // machine up to it and cache it for the next instances. The scratch
+    // machine starts from a copy of the save, whose contents are part of the
+    // cache key, and its battery RAM is restored with the rest; the MBC3
+    // clock is not, and keeps running.
+    std::optional<WarmStartPoint> warm_start;
+};
+
+enum WarmStartStatus
+{
+    WARM_START_NONE,        // Not asked for
+    WARM_START_RESTORED,    // Restored at the start point
+    WARM_START_UNREACHED,   // The start point is never reached; started normally
+    WARM_START_FAILED       // The snapshot could not be made or loaded; started normally
+};
+
+// A complete machine: owns every unit and wires them into the memory map.
+class GameBoy
+{
+public:
+    Scheduler scheduler;
+    SpeedSwitch speed_switch;
+    MMU mmu;
+    Interrupts irq;
+    Boot boot;
+    Cartridge cartridge;
+    WorkRam wram;
+    VideoRam vram;
+    Oam oam;
+    HighRam hram;
+    Timer timer;
+    Serial serial;
+    CPU cpu;
+    Dma dma;
+    Joypad joypad;
+    Ppu ppu;
+
+    explicit GameBoy(const std::string& rom_path, const GameBoyOptions& options = {});
+    GameBoy(const GameBoy&) = delete;
+    GameBoy& operator=(const GameBoy&) = delete;
+
+    static constexpr ulong frame_cycles = 70224;
+
+    void step();
+    void finish_instruction();
+    void run_until(const ulong cycles);
+
+    WarmStartStatus warm_start_status() const { return warm_status; }
+
+    // States are taken between instructions; see finish_instruction. A
+    // state that fails to load leaves the machine as it was.
+    std::vector<ubyte> save_state(const bool with_cartridge = true, const bool with_clock = true) const;
+    bool load_state(const ubyte* data, const size_t size);
+
+    std::string cache_path(const std::string& cache_dir, const std::string& extension) const;
+
+private:
+    static constexpr ulong boot_timeout = 5 * Scheduler::frequency;
+    static constexpr ulong warm_start_timeout = 120 * Scheduler::frequency;
+
+    WarmStartStatus warm_status{ WARM_START_NONE };
+
+    bool restore_state(const ubyte* data, const size_t size);
+    void update_cgb_mode();
+    void start_boot_rom();
+    bool fast_boot(const std::string& rom_path, const GameBoyOptions& options);
+    WarmStartStatus warm_start(const std::string& rom_path, const GameBoyOptions& options);
+};
@@ -0,0 +1,93 @@
+#include "joypad.hpp"
+
+#include <algorithm>
+
+Joypad::Joypad(Scheduler& scheduler, Interrupts& irq, CPU& cpu)
+    : scheduler(scheduler), irq(irq), cpu(cpu), buttons(0x00), select(0x30)
+{
+    scheduler.on(JOYPAD, [this](ulong when) { apply(when); });
+}
+
+bool Joypad::accepts(const ushort addr) const
+{
+    return addr == 0xFF00;
+}
+
+ubyte Joypad::read(const ushort addr) const
+{
+    return 0xC0 | select | lines();
+}
+
+void Joypad::write(const ushort addr, const ubyte value)
+{
+    const ubyte before = lines();
+    select = value & 0x30;
+
+    // Selecting a group with a button already down also pulls a line low
+    if (before & ~lines())
+        irq.IF_INPUT = 1;
+}
+
+void Joypad::poll()
+{
+    if (scheduler.pending(JOYPAD))
+        return;
+
+    if (const InputEvent* next = inputs.peek())
+        scheduler.schedule(JOYPAD, std::max(next->cycle, scheduler.now()));
+}
+
+void Joypad::press(const ubyte buttons)
+{
+    const ubyte before = lines();
+    this->buttons = buttons;
+
+    if (before & ~lines())
+    {
+        irq.IF_INPUT = 1;
+        cpu.stopped = false;
+    }
+}
+
+void Joypad::save_state(StateWriter& state) const
+{
+    state.value(buttons);
+    state.value(select);
+}
+
+void Joypad::load_state(StateReader& state)
+{
+    state.value(buttons);
+    state.value(select);
+}
+
+// Low nibble of P1: 0 for each pressed button of the selected groups
+ubyte Joypad::lines() const
+{
+    ubyte res = 0x00;
+
+    if (!(select & 0x10))
+        res |= buttons & 0x0F;
+    if (!(select & 0x20))
+        res |= buttons >> 4;
+
+    return ~res & 0x0F;
+}
+
+void Joypad::apply(ulong when)
+{
+    InputEvent input;
+    while (inputs.pop(input))
+    {
+        press(input.buttons);
+        if (applied)
+            applied({ when, input.buttons });
+
+        const InputEvent* next = inputs.peek();
+        if (next && next->cycle > when)
+        {
+            scheduler.schedule(JOYPAD, next->cycle);
+            return;
+        }
+    }
+}
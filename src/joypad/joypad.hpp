@@ -0,0 +1,73 @@
+#pragma once
+
+#include <memory/memory_unit.hpp>
+#include <cpu/cpu.hpp>
+#include <cpu/interrupts.hpp>
+#include <scheduler/scheduler.hpp>
+#include <state/state.hpp>
+#include <utils/spsc_queue.hpp>
+#include <functional>
+
+enum Button : ubyte
+{
+    BUTTON_RIGHT  = 0x01,
+    BUTTON_LEFT   = 0x02,
+    BUTTON_UP     = 0x04,
+    BUTTON_DOWN   = 0x08,
+    BUTTON_A      = 0x10,
+    BUTTON_B      = 0x20,
+    BUTTON_SELECT = 0x40,
+    BUTTON_START  = 0x80
+};
+
+// Buttons held down (a mask of Button) from master clock time `cycle` on
+struct InputEvent
+{
+    ulong cycle;
+    ubyte buttons;
+};
+
+// P1 (0xFF00). Inputs are pushed from any one thread and applied on the
+// emulation thread by a JOYPAD event at their exact timestamp. The queue is
+// checked each time the machine is run; inputs timestamped earlier than
+// that are applied as soon as they are seen.
+class Joypad : public MemoryUnit
+{
+private:
+    Scheduler& scheduler;
+    Interrupts& irq;
+    CPU& cpu;
+
+    SpscQueue<InputEvent, 256> inputs;
+    ubyte buttons;
+    ubyte select;
+
+    std::function<void(const InputEvent&)> applied;
+
+public:
+    Joypad(Scheduler& scheduler, Interrupts& irq, CPU& cpu);
+
+    bool accepts(const ushort addr) const override;
+    ubyte read(const ushort addr) const override;
+    void write(const ushort addr, const ubyte value) override;
+
+    // Producer side; false if the queue is full
+    bool push(const InputEvent& input) { return inputs.push(input); }
+
+    // Consumer side; schedules the next queued input if none is pending
+    void poll();
+
+    ubyte pressed() const { return buttons; }
+    void press(const ubyte buttons);
+
+    // Called with every queued input as it takes effect, stamped with the
+    // cycle it was applied at
+    void on_input(std::function<void(const InputEvent&)> handler) { applied = std::move(handler); }
+
+    void save_state(StateWriter& state) const;
+    void load_state(StateReader& state);
+
+private:
+    ubyte lines() const;
+    void apply(ulong when);
+};
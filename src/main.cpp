@@ -15,7 +15,8 @@ int main()
     foo();
     MMU mmu;
     Interrupts irq;
-    CPU cpu(mmu, irq);
+    Scheduler scheduler;
+    CPU cpu(mmu, irq, scheduler);
 
     cpu.regs.ZF = 0x1;
     std::printf("0x%X\n", cpu.regs.AF);
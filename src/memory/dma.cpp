@@ -0,0 +1,175 @@
+#include "dma.hpp"
+
+#include "../cpu/cpu.hpp"
+#include <algorithm>
+
+Dma::Dma(MMU& mmu, Oam& oam, Scheduler& scheduler, CPU& cpu)
+    : mmu(mmu), oam(oam), scheduler(scheduler), cpu(cpu), oam_source(0xFF), oam_start(0),
+      hdma_source(0), hdma_dest(0x8000), hdma_length(0x7F), hblank_active(false)
+{
+    scheduler.on(OAM_DMA, [this](ulong) { this->mmu.unlock_bus(); });
+    scheduler.on(GENERAL_DMA, [this](ulong) { this->cpu.stalled &= ~STALL_DMA; });
+}
+
+bool Dma::accepts(const ushort addr) const
+{
+    return addr == 0xFF46 || (addr >= 0xFF51 && addr <= 0xFF55) || (oam_active() && blocks(addr));
+}
+
+bool Dma::blocks(const ushort addr) const
+{
+    if (addr >= 0xFE00)
+        return addr < 0xFF00;
+
+    const bool video_bus = addr >= 0x8000 && addr < 0xA000;
+    return video_bus == source_on_video_bus();
+}
+
+// Pages 8-9 hold video RAM; page 15 also holds OAM, I/O and HRAM
+void Dma::lock_bus()
+{
+    mmu.lock_bus(this, source_on_video_bus() ? 0x8300 : 0xFCFF);
+}
+
+ubyte Dma::read(const ushort addr) const
+{
+    switch (addr)
+    {
+        case 0xFF46: return oam_source;
+        case 0xFF55: return (hblank_active ? 0x00 : 0x80) | hdma_length;
+        case 0xFF51:
+        case 0xFF52:
+        case 0xFF53:
+        case 0xFF54: return 0xFF;
+        default: break;
+    }
+
+    if (addr >= 0xFE00)
+        return 0xFF;
+
+    const ulong elapsed = scheduler.cpu_now() - oam_start;
+    const ulong index = elapsed < oam_setup_cycles ? 0 : std::min<ulong>((elapsed - oam_setup_cycles) / 4, 159);
+    return oam.data()[index];
+}
+
+void Dma::write(const ushort addr, const ubyte value)
+{
+    switch (addr)
+    {
+        case 0xFF46: start_oam(value); break;
+        case 0xFF51: hdma_source = (hdma_source & 0x00FF) | value << 8; break;
+        case 0xFF52: hdma_source = (hdma_source & 0xFF00) | (value & 0xF0); break;
+        case 0xFF53: hdma_dest = 0x8000 | (hdma_dest & 0x00FF) | (value & 0x1F) << 8; break;
+        case 0xFF54: hdma_dest = (hdma_dest & 0xFF00) | (value & 0xF0); break;
+        case 0xFF55: start_hdma(value); break;
+        default: break;
+    }
+}
+
+void Dma::hblank()
+{
+    if (!hblank_active)
+        return;
+
+    copy_blocks(1);
+    stall(block_cycles);
+
+    if (hdma_length-- == 0)
+    {
+        hdma_length = 0x7F;
+        hblank_active = false;
+    }
+}
+
+void Dma::start_oam(const ubyte value)
+{
+    oam_source = value;
+    oam_start = scheduler.cpu_now();
+
+    // 0xE000-0xFFFF sources read the work RAM echo
+    const ushort source = (value >= 0xE0 ? value - 0x20 : value) << 8;
+    oam.before_write();
+    mmu.read_block(source, oam.data(), 0xA0);
+
+    lock_bus();
+    scheduler.schedule_cpu(OAM_DMA, oam_start + oam_setup_cycles + oam_cycles);
+}
+
+void Dma::start_hdma(const ubyte value)
+{
+    if (hblank_active && !(value & 0x80))
+    {
+        hblank_active = false;
+        hdma_length = 0x80 | hdma_length;
+        return;
+    }
+
+    hdma_length = value & 0x7F;
+
+    if (value & 0x80)
+    {
+        hblank_active = true;
+        if (hblank_armed)
+            hblank_armed();
+        return;
+    }
+
+    const uint n_blocks = hdma_length + 1;
+    copy_blocks(n_blocks);
+    stall(n_blocks * block_cycles);
+    hdma_length = 0x7F;
+}
+
+void Dma::copy_blocks(const uint n_blocks)
+{
+    ubyte buffer[0x800];
+    const uint count = n_blocks * 0x10;
+
+    mmu.read_block(hdma_source, buffer, count);
+
+    // The destination wraps inside VRAM
+    for (uint done = 0; done < count;)
+    {
+        const uint chunk = std::min<uint>(count - done, 0xA000 - hdma_dest);
+        mmu.write_block(hdma_dest, buffer + done, chunk);
+        hdma_dest = 0x8000 | ((hdma_dest + chunk) & 0x1FF0);
+        done += chunk;
+    }
+    hdma_source += count;
+}
+
+void Dma::stall(const ulong cycles)
+{
+    cpu.stalled |= STALL_DMA;
+    scheduler.schedule(GENERAL_DMA, scheduler.now() + cycles);
+}
+
+
+void Dma::save_state(StateWriter& state) const
+{
+    state.value(oam_source);
+    state.value(oam_start);
+    state.value(oam_active());
+    state.value(hdma_source);
+    state.value(hdma_dest);
+    state.value(hdma_length);
+    state.value(hblank_active);
+}
+
+void Dma::load_state(StateReader& state)
+{
+    bool locked = false;
+
+    state.value(oam_source);
+    state.value(oam_start);
+    state.value(locked);
+    state.value(hdma_source);
+    state.value(hdma_dest);
+    state.value(hdma_length);
+    state.value(hblank_active);
+
+    if (locked)
+        lock_bus();
+    else
+        mmu.unlock_bus();
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "memory_unit.hpp"
+#include "mmu.hpp"
+#include "oam.hpp"
+#include "../state/state.hpp"
+#include "../scheduler/scheduler.hpp"
+#include <functional>
+
+struct CPU;
+
+// OAM DMA (0xFF46) and CGB general/HBlank DMA (0xFF51-0xFF55). Each transfer
+// is a single bulk copy; the scheduler only tracks how long the bus stays
+// busy. During OAM DMA this unit takes over OAM and the bus the source is
+// on (video RAM, or the external bus with the cartridge and work RAM) and
+// answers CPU reads there with the byte the transfer would be moving at
+// that point. The other bus, the I/O registers and HRAM stay open.
+class Dma : public MemoryUnit
+{
+private:
+    MMU& mmu;
+    Oam& oam;
+    Scheduler& scheduler;
+    CPU& cpu;
+
+    ubyte oam_source;
+    ulong oam_start;        // On the CPU clock
+
+    ushort hdma_source;
+    ushort hdma_dest;
+    ubyte hdma_length;
+    bool hblank_active;
+    std::function<void()> hblank_armed;
+
+public:
+    static constexpr ulong oam_setup_cycles = 4;
+    static constexpr ulong oam_cycles = 160 * 4;
+    static constexpr ulong block_cycles = 32;   // Same in both speed modes
+
+    Dma(MMU& mmu, Oam& oam, Scheduler& scheduler, CPU& cpu);
+
+    bool accepts(const ushort addr) const override;
+    ubyte read(const ushort addr) const override;
+    void write(const ushort addr, const ubyte value) override;
+
+    bool oam_active() const { return mmu.bus_locked(); }
+
+    // The LCD calls hblank at the start of every HBlank while an HBlank
+    // transfer is pending, and is told when one starts
+    bool hblank_pending() const { return hblank_active; }
+    void on_hblank_armed(std::function<void()> handler) { hblank_armed = std::move(handler); }
+    void hblank();
+
+    void save_state(StateWriter& state) const;
+    void load_state(StateReader& state);
+
+private:
+    bool source_on_video_bus() const { return (oam_source >> 5) == 4; }
+    bool blocks(const ushort addr) const;
+    void lock_bus();
+    void start_oam(const ubyte value);
+    void start_hdma(const ubyte value);
+    void copy_blocks(const uint n_blocks);
+    void stall(const ulong cycles);
+};
@@ -0,0 +1,26 @@
+#include "high_ram.hpp"
+
+bool HighRam::accepts(const ushort addr) const
+{
+    return addr >= 0xFF80 && addr < 0xFFFF;
+}
+
+ubyte HighRam::read(const ushort addr) const
+{
+    return memory[addr - 0xFF80];
+}
+
+void HighRam::write(const ushort addr, const ubyte value)
+{
+    memory[addr - 0xFF80] = value;
+}
+
+void HighRam::save_state(StateWriter& state) const
+{
+    state.value(memory);
+}
+
+void HighRam::load_state(StateReader& state)
+{
+    state.value(memory);
+}
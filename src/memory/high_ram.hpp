@@ -0,0 +1,20 @@
+#pragma once
+
+#include "memory_unit.hpp"
+#include "../state/state.hpp"
+#include <array>
+
+// High RAM at 0xFF80-0xFFFE.
+class HighRam : public MemoryUnit
+{
+private:
+    std::array<ubyte, 0x7F> memory{};
+
+public:
+    bool accepts(const ushort addr) const override;
+    ubyte read(const ushort addr) const override;
+    void write(const ushort addr, const ubyte value) override;
+
+    void save_state(StateWriter& state) const;
+    void load_state(StateReader& state);
+};
@@ -1,23 +1,124 @@
 #include "mmu.hpp"
 
-MMU::MMU() {}
+#include <algorithm>
+#include <cstring>
+
+MMU::MMU() : reads(read_pages.data()), writes(write_pages.data()), bus_owner(nullptr), locked_pages(0) {}
 
 void MMU::load(MemoryUnit* mem_unit)
 {
     memory_map.push_back(mem_unit);
 }
 
-ubyte MMU::read(const ushort address) const
+void MMU::map(const ushort address, const uint size, ubyte* memory)
+{
+    for (uint offset = 0; offset < size; offset += page_size)
+        set_page((address + offset) >> page_shift, memory + offset, memory + offset);
+}
+
+void MMU::map_read(const ushort address, const uint size, const ubyte* memory)
+{
+    for (uint offset = 0; offset < size; offset += page_size)
+        set_page((address + offset) >> page_shift, memory + offset, nullptr);
+}
+
+void MMU::unmap(const ushort address, const uint size)
+{
+    for (uint offset = 0; offset < size; offset += page_size)
+        set_page((address + offset) >> page_shift, nullptr, nullptr);
+}
+
+void MMU::set_page(const uint page, const ubyte* read, ubyte* write)
+{
+    read_pages[page] = read;
+    write_pages[page] = write;
+
+    const bool locked = (locked_pages >> page) & 1;
+    locked_reads[page] = locked ? nullptr : read;
+    locked_writes[page] = locked ? nullptr : write;
+}
+
+void MMU::lock_bus(MemoryUnit* owner, const ushort pages)
 {
+    bus_owner = owner;
+    locked_pages = pages;
+
+    for (uint page = 0; page < n_pages; page++)
+        set_page(page, read_pages[page], write_pages[page]);
+
+    reads = locked_reads.data();
+    writes = locked_writes.data();
+}
+
+void MMU::unlock_bus()
+{
+    bus_owner = nullptr;
+    locked_pages = 0;
+    reads = read_pages.data();
+    writes = write_pages.data();
+}
+
+void MMU::read_block(const ushort address, ubyte* dest, const uint count) const
+{
+    for (uint done = 0; done < count;)
+    {
+        const ushort addr = address + done;
+        const uint chunk = std::min(count - done, page_size - (addr & (page_size - 1)));
+
+        if (const ubyte* page = read_pages[addr >> page_shift])
+            std::memcpy(dest + done, page + (addr & (page_size - 1)), chunk);
+        else
+            for (uint i = 0; i < chunk; i++)
+            {
+                dest[done + i] = 0xFF;
+                for (const auto unit : memory_map)
+                    if (unit->accepts(addr + i))
+                    {
+                        dest[done + i] = unit->read(addr + i);
+                        break;
+                    }
+            }
+
+        done += chunk;
+    }
+}
+
+void MMU::write_block(const ushort address, const ubyte* src, const uint count)
+{
+    for (uint done = 0; done < count;)
+    {
+        const ushort addr = address + done;
+        const uint chunk = std::min(count - done, page_size - (addr & (page_size - 1)));
+
+        if (ubyte* page = write_pages[addr >> page_shift])
+            std::memcpy(page + (addr & (page_size - 1)), src + done, chunk);
+        else
+            for (uint i = 0; i < chunk; i++)
+                for (const auto unit : memory_map)
+                    if (unit->accepts(addr + i))
+                        unit->write(addr + i, src[done + i]);
+
+        done += chunk;
+    }
+}
+
+ubyte MMU::read_unit(const ushort address) const
+{
+    if (bus_owner && bus_owner->accepts(address))
+        return bus_owner->read(address);
+
     for (const auto unit : memory_map)
         if (unit->accepts(address))
             return unit->read(address);
     return 0xFF;
 }
 
-void MMU::write(const ushort address, const ubyte value)
+void MMU::write_unit(const ushort address, const ubyte value)
 {
+    if (bus_owner && bus_owner->accepts(address))
+        return bus_owner->write(address, value);
+
     for (const auto unit : memory_map)
         if (unit->accepts(address))
             unit->write(address, value);
-}
\ No newline at end of file
+}
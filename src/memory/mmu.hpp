@@ -1,17 +1,66 @@
 #pragma once
 
 #include "memory_unit.hpp"
+#include <array>
 #include <vector>
 
+// Address space split in 4 KiB pages. Plain memory is mapped straight into
+// the page tables so accesses to it skip the memory units; unmapped pages
+// fall back to the first unit that accepts the address.
 class MMU
 {
 private:
+    static constexpr uint page_shift = 12;
+    static constexpr uint page_size = 1 << page_shift;
+    static constexpr uint n_pages = 0x10000 >> page_shift;
+
+    std::array<const ubyte*, n_pages> read_pages{};
+    std::array<ubyte*, n_pages> write_pages{};
     std::vector<MemoryUnit*> memory_map;
 
+    // While the bus is locked the CPU goes through the locking unit first on
+    // the locked pages, which are left out of these copies of the tables
+    std::array<const ubyte*, n_pages> locked_reads{};
+    std::array<ubyte*, n_pages> locked_writes{};
+    const ubyte* const* reads;
+    ubyte* const* writes;
+    MemoryUnit* bus_owner;
+    ushort locked_pages;
+
 public:
     MMU();
     void load(MemoryUnit* mem_unit);
 
-    ubyte read(const ushort address) const;
-    void write(const ushort address, const ubyte value);
-};
\ No newline at end of file
+    void map(const ushort address, const uint size, ubyte* memory);
+    void map_read(const ushort address, const uint size, const ubyte* memory);
+    void unmap(const ushort address, const uint size);
+
+    // `pages` has bit n set for each 4 KiB page n the owner may claim
+    void lock_bus(MemoryUnit* owner, const ushort pages);
+    void unlock_bus();
+    bool bus_locked() const { return bus_owner != nullptr; }
+
+    // Bulk transfers for DMA, page by page and bypassing the bus lock
+    void read_block(const ushort address, ubyte* dest, const uint count) const;
+    void write_block(const ushort address, const ubyte* src, const uint count);
+
+    ubyte read(const ushort address) const
+    {
+        if (const ubyte* page = reads[address >> page_shift])
+            return page[address & (page_size - 1)];
+        return read_unit(address);
+    }
+
+    void write(const ushort address, const ubyte value)
+    {
+        if (ubyte* page = writes[address >> page_shift])
+            page[address & (page_size - 1)] = value;
+        else
+            write_unit(address, value);
+    }
+
+private:
+    void set_page(const uint page, const ubyte* read, ubyte* write);
+    ubyte read_unit(const ushort address) const;
+    void write_unit(const ushort address, const ubyte value);
+};
@@ -0,0 +1,31 @@
+#include "oam.hpp"
+
+bool Oam::accepts(const ushort addr) const
+{
+    return addr >= 0xFE00 && addr < 0xFF00;
+}
+
+ubyte Oam::read(const ushort addr) const
+{
+    return (addr < 0xFEA0) ? memory[addr - 0xFE00] : 0x00;
+}
+
+void Oam::write(const ushort addr, const ubyte value)
+{
+    if (addr < 0xFEA0)
+    {
+        before_write();
+        memory[addr - 0xFE00] = value;
+    }
+}
+
+
+void Oam::save_state(StateWriter& state) const
+{
+    state.value(memory);
+}
+
+void Oam::load_state(StateReader& state)
+{
+    state.value(memory);
+}
\ No newline at end of file
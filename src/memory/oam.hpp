@@ -0,0 +1,33 @@
+#pragma once
+
+#include "memory_unit.hpp"
+#include "../state/state.hpp"
+#include <array>
+#include <functional>
+
+// Object attribute memory at 0xFE00-0xFE9F, plus the unusable area up to 0xFEFF.
+class Oam : public MemoryUnit
+{
+private:
+    std::array<ubyte, 0xA0> memory{};
+    std::function<void()> write_handler;
+
+public:
+    bool accepts(const ushort addr) const override;
+    ubyte read(const ushort addr) const override;
+    void write(const ushort addr, const ubyte value) override;
+
+    ubyte* data() { return memory.data(); }
+    const ubyte* data() const { return memory.data(); }
+
+    // Called before OAM changes, including bulk copies through data()
+    void on_write(std::function<void()> handler) { write_handler = std::move(handler); }
+    void before_write() const
+    {
+        if (write_handler)
+            write_handler();
+    }
+
+    void save_state(StateWriter& state) const;
+    void load_state(StateReader& state);
+};
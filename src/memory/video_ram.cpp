@@ -0,0 +1,77 @@
+#include "video_ram.hpp"
+
+#include "../ppu/tile_cache.hpp"
+
+VideoRam::VideoRam(MMU& mmu) : mmu(mmu), cache(nullptr), vbk(0), cgb_mode(true)
+{
+    map_bank();
+}
+
+bool VideoRam::accepts(const ushort addr) const
+{
+    return (addr >= 0x8000 && addr < 0xA000) || (cgb_mode && addr == 0xFF4F);
+}
+
+ubyte VideoRam::read(const ushort addr) const
+{
+    if (addr < 0xA000)
+        return banks[vbk][addr - 0x8000];
+
+    return 0xFE | vbk;
+}
+
+void VideoRam::write(const ushort addr, const ubyte value)
+{
+    if (addr < 0xA000)
+    {
+        if (write_handler)
+            write_handler();
+
+        banks[vbk][addr - 0x8000] = value;
+        if (cache)
+            cache->invalidate(vbk, addr - 0x8000);
+        return;
+    }
+
+    vbk = value & 0x1;
+    map_bank();
+}
+
+void VideoRam::set_cgb_mode(const bool cgb)
+{
+    cgb_mode = cgb;
+    if (!cgb_mode)
+    {
+        vbk = 0;
+        map_bank();
+    }
+}
+
+void VideoRam::attach(TileCache* cache)
+{
+    this->cache = cache;
+    if (cache)
+        cache->invalidate_all();
+}
+
+void VideoRam::map_bank()
+{
+    mmu.map_read(0x8000, 0x2000, banks[vbk].data());
+}
+
+
+void VideoRam::save_state(StateWriter& state) const
+{
+    state.value(banks);
+    state.value(vbk);
+}
+
+void VideoRam::load_state(StateReader& state)
+{
+    state.value(banks);
+    state.value(vbk);
+    map_bank();
+
+    if (cache)
+        cache->invalidate_all();
+}
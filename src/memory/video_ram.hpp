@@ -0,0 +1,47 @@
+#pragma once
+
+#include "memory_unit.hpp"
+#include "mmu.hpp"
+#include "../state/state.hpp"
+#include <array>
+#include <functional>
+
+class TileCache;
+
+// CGB video RAM: two 8 KiB banks at 0x8000 selected by VBK. Reads go
+// through read-only MMU pages; writes come through the unit so the tile
+// cache can drop the rows they touch. In DMG mode VBK is absent and bank 0
+// stays mapped.
+class VideoRam : public MemoryUnit
+{
+private:
+    MMU& mmu;
+    TileCache* cache;
+    std::function<void()> write_handler;
+
+    std::array<std::array<ubyte, 0x2000>, 2> banks{};
+    ubyte vbk;
+    bool cgb_mode;
+
+public:
+    VideoRam(MMU& mmu);
+
+    bool accepts(const ushort addr) const override;
+    ubyte read(const ushort addr) const override;
+    void write(const ushort addr, const ubyte value) override;
+
+    void attach(TileCache* cache);
+
+    // Called before every write to video memory
+    void on_write(std::function<void()> handler) { write_handler = std::move(handler); }
+
+    uint bank() const { return vbk; }
+    void set_cgb_mode(const bool cgb);
+    const ubyte* data(const uint bank) const { return banks[bank].data(); }
+
+    void save_state(StateWriter& state) const;
+    void load_state(StateReader& state);
+
+private:
+    void map_bank();
+};
@@ -0,0 +1,67 @@
+#include "work_ram.hpp"
+
+WorkRam::WorkRam(MMU& mmu) : mmu(mmu), svbk(0), cgb_mode(true)
+{
+    mmu.map(0xC000, 0x1000, banks[0].data());
+    mmu.map(0xE000, 0x1000, banks[0].data());
+    map_banks();
+}
+
+// Pages are only mapped up to 0xEFFF; the echo at 0xF000-0xFDFF shares its
+// page with OAM and I/O and goes through this unit instead.
+bool WorkRam::accepts(const ushort addr) const
+{
+    return (addr >= 0xF000 && addr < 0xFE00) || (cgb_mode && addr == 0xFF70);
+}
+
+ubyte WorkRam::read(const ushort addr) const
+{
+    if (addr == 0xFF70)
+        return 0xF8 | svbk;
+    return banks[bank()][addr & 0xFFF];
+}
+
+void WorkRam::write(const ushort addr, const ubyte value)
+{
+    if (addr == 0xFF70)
+    {
+        svbk = value & 0x7;
+        map_banks();
+    }
+    else
+        banks[bank()][addr & 0xFFF] = value;
+}
+
+uint WorkRam::bank() const
+{
+    return svbk ? svbk : 1;
+}
+
+void WorkRam::set_cgb_mode(const bool cgb)
+{
+    cgb_mode = cgb;
+    if (!cgb_mode)
+    {
+        svbk = 0;
+        map_banks();
+    }
+}
+
+void WorkRam::map_banks()
+{
+    mmu.map(0xD000, 0x1000, banks[bank()].data());
+}
+
+
+void WorkRam::save_state(StateWriter& state) const
+{
+    state.value(banks);
+    state.value(svbk);
+}
+
+void WorkRam::load_state(StateReader& state)
+{
+    state.value(banks);
+    state.value(svbk);
+    map_banks();
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "memory_unit.hpp"
+#include "mmu.hpp"
+#include "../state/state.hpp"
+#include <array>
+
+// CGB work RAM: bank 0 at 0xC000, banks 1-7 switched into 0xD000 by SVBK.
+// Switching only repoints the MMU page. In DMG mode SVBK is absent and
+// bank 1 stays mapped.
+class WorkRam : public MemoryUnit
+{
+private:
+    MMU& mmu;
+
+    std::array<std::array<ubyte, 0x1000>, 8> banks{};
+    ubyte svbk;
+    bool cgb_mode;
+
+public:
+    WorkRam(MMU& mmu);
+
+    bool accepts(const ushort addr) const override;
+    ubyte read(const ushort addr) const override;
+    void write(const ushort addr, const ubyte value) override;
+
+    uint bank() const;
+    void set_cgb_mode(const bool cgb);
+
+    void save_state(StateWriter& state) const;
+    void load_state(StateReader& state);
+
+private:
+    void map_banks();
+};
@@ -0,0 +1,139 @@
+#include "color_converter.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+namespace
+{
+    uint expand5(const uint c) { return (c << 3) | (c >> 2); }
+
+    uint to_rgba(const ushort c)
+    {
+        return expand5(c & 0x1F) | expand5((c >> 5) & 0x1F) << 8 | expand5((c >> 10) & 0x1F) << 16 | 0xFF000000u;
+    }
+
+    ushort to_rgb565(const ushort c)
+    {
+        const uint g = (c >> 5) & 0x1F;
+        return ushort((c & 0x1F) << 11 | ((g << 1) | (g >> 4)) << 5 | ((c >> 10) & 0x1F));
+    }
+}
+
+ColorConverter::ColorConverter(const PixelFormat format, const bool color_correction)
+{
+    configure(format, color_correction);
+}
+
+void ColorConverter::configure(const PixelFormat format, const bool color_correction)
+{
+    this->format = format;
+    corrected = color_correction;
+
+    rgba_table.clear();
+    rgb565_table.clear();
+    if (corrected)
+        build_tables();
+}
+
+// The CGB screen is darker and bleeds between channels; this is the usual
+// approximation of it, with every channel capped at 240
+void ColorConverter::build_tables()
+{
+    if (format == PixelFormat::RGBA8888)
+        rgba_table.resize(0x8000);
+    else
+        rgb565_table.resize(0x8000);
+
+    for (uint c = 0; c < 0x8000; c++)
+    {
+        const uint r = c & 0x1F, g = (c >> 5) & 0x1F, b = (c >> 10) & 0x1F;
+        const uint r8 = std::min(960u, r * 26 + g * 4 + b * 2) >> 2;
+        const uint g8 = std::min(960u, g * 24 + b * 8) >> 2;
+        const uint b8 = std::min(960u, r * 6 + g * 4 + b * 22) >> 2;
+
+        if (format == PixelFormat::RGBA8888)
+            rgba_table[c] = r8 | g8 << 8 | b8 << 16 | 0xFF000000u;
+        else
+            rgb565_table[c] = ushort((r8 >> 3) << 11 | (g8 >> 2) << 5 | (b8 >> 3));
+    }
+}
+
+void ColorConverter::convert(const ushort* pixels, void* out, const size_t count) const
+{
+    size_t i = 0;
+
+    if (corrected && format == PixelFormat::RGBA8888)
+    {
+        uint* dst = static_cast<uint*>(out);
+        #if defined(__AVX2__)
+            const int* table = reinterpret_cast<const int*>(rgba_table.data());
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m256i index = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i)));
+                const __m256i colors = _mm256_i32gather_epi32(table, _mm256_and_si256(index, _mm256_set1_epi32(0x7FFF)), 4);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), colors);
+            }
+        #endif
+        for (; i < count; i++)
+            dst[i] = rgba_table[pixels[i] & 0x7FFF];
+        return;
+    }
+
+    if (corrected)
+    {
+        ushort* dst = static_cast<ushort*>(out);
+        for (; i < count; i++)
+            dst[i] = rgb565_table[pixels[i] & 0x7FFF];
+        return;
+    }
+
+    #if defined(__SSE2__)
+        const __m128i five = _mm_set1_epi16(0x1F);
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i));
+            const __m128i r = _mm_and_si128(c, five);
+            const __m128i g = _mm_and_si128(_mm_srli_epi16(c, 5), five);
+            const __m128i b = _mm_and_si128(_mm_srli_epi16(c, 10), five);
+
+            if (format == PixelFormat::RGBA8888)
+            {
+                // 16-bit lanes of R | G << 8 and B | A << 8, interleaved
+                const __m128i r8 = _mm_or_si128(_mm_slli_epi16(r, 3), _mm_srli_epi16(r, 2));
+                const __m128i g8 = _mm_or_si128(_mm_slli_epi16(g, 3), _mm_srli_epi16(g, 2));
+                const __m128i b8 = _mm_or_si128(_mm_slli_epi16(b, 3), _mm_srli_epi16(b, 2));
+                const __m128i rg = _mm_or_si128(r8, _mm_slli_epi16(g8, 8));
+                const __m128i ba = _mm_or_si128(b8, _mm_set1_epi16(short(0xFF00)));
+
+                __m128i* dst = reinterpret_cast<__m128i*>(static_cast<uint*>(out) + i);
+                _mm_storeu_si128(dst, _mm_unpacklo_epi16(rg, ba));
+                _mm_storeu_si128(dst + 1, _mm_unpackhi_epi16(rg, ba));
+            }
+            else
+            {
+                const __m128i g6 = _mm_or_si128(_mm_slli_epi16(g, 1), _mm_srli_epi16(g, 4));
+                const __m128i rgb = _mm_or_si128(_mm_or_si128(_mm_slli_epi16(r, 11), _mm_slli_epi16(g6, 5)), b);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(static_cast<ushort*>(out) + i), rgb);
+            }
+        }
+    #endif
+
+    if (format == PixelFormat::RGBA8888)
+    {
+        uint* dst = static_cast<uint*>(out);
+        for (; i < count; i++)
+            dst[i] = to_rgba(pixels[i]);
+    }
+    else
+    {
+        ushort* dst = static_cast<ushort*>(out);
+        for (; i < count; i++)
+            dst[i] = to_rgb565(pixels[i]);
+    }
+}
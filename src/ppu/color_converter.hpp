@@ -0,0 +1,40 @@
+#pragma once
+
+#include "lcd_registers.hpp"
+#include <types.hpp>
+#include <cstddef>
+#include <vector>
+
+enum class PixelFormat
+{
+    RGBA8888,   // Bytes R, G, B, A in memory
+    RGB565
+};
+
+// Turns BGR555 framebuffer pixels into a display format. Plain conversion
+// is pure bit shuffling, eight pixels at a time with SSE2. Color
+// correction, which mixes the channels the way the CGB screen does, goes
+// through a table of all 32768 colors built when the settings change.
+class ColorConverter
+{
+private:
+    PixelFormat format;
+    bool corrected;
+
+    std::vector<uint> rgba_table;
+    std::vector<ushort> rgb565_table;
+
+public:
+    explicit ColorConverter(const PixelFormat format = PixelFormat::RGBA8888, const bool color_correction = false);
+
+    void configure(const PixelFormat format, const bool color_correction);
+    PixelFormat pixel_format() const { return format; }
+    size_t pixel_size() const { return format == PixelFormat::RGBA8888 ? 4 : 2; }
+
+    // `out` holds count * pixel_size() bytes
+    void convert(const ushort* pixels, void* out, const size_t count) const;
+    void convert(const Framebuffer& frame, void* out) const { convert(frame.data(), out, frame.size()); }
+
+private:
+    void build_tables();
+};
@@ -0,0 +1,172 @@
+#include "fifo_renderer.hpp"
+
+#include <algorithm>
+
+FifoRenderer::FifoRenderer(const VideoRam& vram, const Oam& oam, TileCache& tiles, ObjectTable& objects, const bool cgb)
+    : fetcher(vram, oam, tiles, objects, cgb), out(nullptr), window_line(0), window_triggered(false), dot(0), stall(0), x(screen_width),
+      discard(0), fifo_pos(8), fetch_column(0), in_window(false), n_objects(0), next_object(0)
+{}
+
+LineTiming FifoRenderer::start_line(const LcdRegisters& regs, const uint window_line, const bool window_triggered, ushort* out)
+{
+    this->out = out;
+    this->window_line = window_line;
+    this->window_triggered = window_triggered;
+
+    dot = 0;
+    stall = startup_dots;
+    x = 0;
+    discard = regs.scx & 7;
+    fifo_pos = 8;
+    fetch_column = 0;
+    in_window = false;
+    next_object = 0;
+    obj_line.fill(0);
+
+    return measure_line(regs, window_triggered);
+}
+
+LineTiming FifoRenderer::measure_line(const LcdRegisters& regs, const bool window_triggered)
+{
+    this->window_triggered = window_triggered;
+
+    const bool window = fetcher.shows_window(regs, window_triggered);
+    ulong length = startup_dots + (regs.scx & 7) + screen_width;
+    if (window)
+        length += window_dots + (regs.wx < 7 ? 7 - regs.wx : 0);
+
+    return { length + queue_objects(regs), window };
+}
+
+// Picks the line's objects in fetch order; returns their total stall
+ulong FifoRenderer::queue_objects(const LcdRegisters& regs)
+{
+    ulong length = 0;
+
+    n_objects = 0;
+    if (regs.objects_enabled())
+    {
+        const ubyte* attrs = fetcher.attributes();
+        const ObjectLine& selected = fetcher.select_objects(regs);
+
+        for (uint n = 0; n < selected.count; n++)
+            if (attrs[selected.index[n] * 4 + 1] < 168)
+                objects[n_objects++] = selected.index[n];
+
+        // Already in X order on DMG
+        if (fetcher.cgb_mode())
+            std::stable_sort(objects.begin(), objects.begin() + n_objects,
+                             [attrs](const ubyte a, const ubyte b) { return attrs[a * 4 + 1] < attrs[b * 4 + 1]; });
+
+        // The first object over a background tile also waits for that
+        // tile's fetch to finish
+        uint last_column = ~0u;
+        for (uint n = 0; n < n_objects; n++)
+        {
+            const uint obj_x = attrs[objects[n] * 4 + 1];
+            const uint column = (obj_x + regs.scx) >> 3;
+
+            penalties[n] = object_dots;
+            if (column != last_column)
+                penalties[n] += 5 - std::min(5u, (obj_x + regs.scx) & 7);
+            last_column = column;
+
+            length += penalties[n];
+        }
+    }
+
+    return length;
+}
+
+void FifoRenderer::sync(const LcdRegisters& regs, const ulong dot)
+{
+    while (this->dot < dot && x < screen_width)
+        step(regs);
+}
+
+void FifoRenderer::finish_line(const LcdRegisters& regs)
+{
+    while (x < screen_width)
+        step(regs);
+}
+
+void FifoRenderer::step(const LcdRegisters& regs)
+{
+    dot++;
+
+    if (stall)
+    {
+        stall--;
+        return;
+    }
+
+    // The dot that notices the window or an object is the first of its stall
+    if (!in_window && !discard && fetcher.shows_window(regs, window_triggered) && int(x) >= int(regs.wx) - 7)
+    {
+        in_window = true;
+        fetch_column = 0;
+        fifo_pos = 8;
+        discard = regs.wx < 7 ? 7 - regs.wx : 0;
+        stall = window_dots - 1;
+        return;
+    }
+
+    if (next_object < n_objects && int(fetcher.attributes()[objects[next_object] * 4 + 1]) - 8 <= int(x))
+    {
+        if (regs.objects_enabled())
+            fetch_object(regs, objects[next_object]);
+
+        stall = penalties[next_object] - 1;
+        next_object++;
+        return;
+    }
+
+    if (fifo_pos == 8)
+        refill(regs);
+
+    const ubyte pixel = fifo[fifo_pos++];
+    if (discard)
+    {
+        discard--;
+        return;
+    }
+
+    out[x] = fetcher.mix(regs, pixel, obj_line[x]);
+    x++;
+}
+
+// Scroll registers are read again on every fetch
+void FifoRenderer::refill(const LcdRegisters& regs)
+{
+    if (!fetcher.draws_bg(regs))
+        fifo.fill(0);
+    else if (in_window)
+        fetcher.map_tile(fifo.data(), regs, regs.window_map_high(), fetch_column, window_line);
+    else
+        fetcher.map_tile(fifo.data(), regs, regs.bg_map_high(), (regs.scx >> 3) + fetch_column, (regs.scy + regs.ly) & 0xFF);
+
+    fetch_column++;
+    fifo_pos = 0;
+}
+
+// Objects are fetched in X order. On DMG the first opaque pixel stays; on
+// CGB a lower OAM index takes over the slot.
+void FifoRenderer::fetch_object(const LcdRegisters& regs, const uint index)
+{
+    ubyte pixels[8];
+    fetcher.object_row(pixels, regs, index);
+
+    const int left = int(fetcher.attributes()[index * 4 + 1]) - 8;
+    for (int i = 0; i < 8; i++)
+    {
+        const int slot = left + i;
+        if (slot < 0 || slot >= int(screen_width) || !(pixels[i] & 3))
+            continue;
+
+        if (!(obj_line[slot] & TileFetcher::obj_opaque) || (fetcher.cgb_mode() && index < obj_owner[slot]))
+        {
+            obj_line[slot] = pixels[i] | TileFetcher::obj_opaque;
+            obj_owner[slot] = index;
+        }
+    }
+}
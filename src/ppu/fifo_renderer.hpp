@@ -0,0 +1,55 @@
+#pragma once
+
+#include "ppu_backend.hpp"
+#include "tile_fetcher.hpp"
+
+// Pixel FIFO renderer: shifts out one pixel per dot and reads the
+// registers as they are at that dot, so writes during mode 3 land on the
+// right pixel. Mode 3 starts with a 12-dot fetch, drops SCX % 8 pixels,
+// stalls 6 dots when the window starts and stalls for every object fetch.
+// The same rules give its length up front, which the Ppu needs to schedule
+// HBlank.
+class FifoRenderer : public PpuBackend
+{
+private:
+    TileFetcher fetcher;
+
+    static constexpr uint startup_dots = 12;
+    static constexpr uint window_dots = 6;
+    static constexpr uint object_dots = 6;
+
+    ushort* out;
+    uint window_line;
+    bool window_triggered;
+
+    ulong dot;
+    uint stall;             // Dots left before the next pixel is shifted out
+    uint x;
+    uint discard;           // Pixels still to drop instead of drawing
+    std::array<ubyte, 8> fifo{};
+    uint fifo_pos;
+    uint fetch_column;
+    bool in_window;
+
+    // Objects in fetch order (by X, then OAM index) with their stall
+    std::array<ubyte, 10> objects{};
+    std::array<ubyte, 10> penalties{};
+    uint n_objects;
+    uint next_object;
+    std::array<ubyte, screen_width> obj_line{};
+    std::array<ubyte, screen_width> obj_owner{};
+
+public:
+    FifoRenderer(const VideoRam& vram, const Oam& oam, TileCache& tiles, ObjectTable& objects, const bool cgb);
+
+    LineTiming start_line(const LcdRegisters& regs, const uint window_line, const bool window_triggered, ushort* out) override;
+    LineTiming measure_line(const LcdRegisters& regs, const bool window_triggered) override;
+    void sync(const LcdRegisters& regs, const ulong dot) override;
+    void finish_line(const LcdRegisters& regs) override;
+
+private:
+    ulong queue_objects(const LcdRegisters& regs);
+    void step(const LcdRegisters& regs);
+    void refill(const LcdRegisters& regs);
+    void fetch_object(const LcdRegisters& regs, const uint index);
+};
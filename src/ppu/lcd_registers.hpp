@@ -0,0 +1,50 @@
+#pragma once
+
+#include <types.hpp>
+#include <array>
+
+constexpr uint screen_width = 160;
+constexpr uint screen_height = 144;
+
+// One BGR555 color per pixel, row by row
+using Framebuffer = std::array<ushort, screen_width * screen_height>;
+
+enum LcdMode : ubyte
+{
+    MODE_HBLANK = 0,
+    MODE_VBLANK = 1,
+    MODE_OAM    = 2,
+    MODE_DRAW   = 3
+};
+
+// LCD registers and palette memory as the renderer sees them.
+struct LcdRegisters
+{
+    ubyte lcdc{ 0x91 };
+    ubyte stat{ 0x00 };     // Interrupt enables only; mode and LYC flag are derived
+    ubyte scy{ 0 };
+    ubyte scx{ 0 };
+    ubyte ly{ 0 };
+    ubyte lyc{ 0 };
+    ubyte bgp{ 0xFC };
+    ubyte obp0{ 0xFF };
+    ubyte obp1{ 0xFF };
+    ubyte wy{ 0 };
+    ubyte wx{ 0 };
+
+    ubyte bcps{ 0 };
+    ubyte ocps{ 0 };
+    std::array<ushort, 32> bg_colors{};     // 8 palettes of 4 colors
+    std::array<ushort, 32> obj_colors{};
+
+    bool operator==(const LcdRegisters&) const = default;
+
+    bool enabled() const { return lcdc & 0x80; }
+    bool window_map_high() const { return lcdc & 0x40; }
+    bool window_enabled() const { return lcdc & 0x20; }
+    bool unsigned_tiles() const { return lcdc & 0x10; }
+    bool bg_map_high() const { return lcdc & 0x08; }
+    bool tall_objects() const { return lcdc & 0x04; }
+    bool objects_enabled() const { return lcdc & 0x02; }
+    bool bg_enabled() const { return lcdc & 0x01; }
+};
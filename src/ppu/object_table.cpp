@@ -0,0 +1,40 @@
+#include "object_table.hpp"
+
+#include "../memory/oam.hpp"
+#include <algorithm>
+
+ObjectTable::ObjectTable(const Oam& oam, const bool cgb) : oam(oam), cgb(cgb), dirty(true), tall(false)
+{}
+
+void ObjectTable::rebuild(const bool tall_objects)
+{
+    const int height = tall_objects ? 16 : 8;
+    const ubyte* attrs = oam.data();
+
+    for (ObjectLine& line : lines)
+        line.count = 0;
+
+    for (uint i = 0; i < 40; i++)
+    {
+        const int top = int(attrs[i * 4]) - 16;
+        const int first = std::max(top, 0);
+        const int last = std::min(top + height, int(screen_height));
+
+        for (int ly = first; ly < last; ly++)
+        {
+            ObjectLine& line = lines[ly];
+            if (line.count < 10)
+                line.index[line.count++] = i;
+        }
+    }
+
+    if (!cgb)
+    {
+        for (ObjectLine& line : lines)
+            std::stable_sort(line.index.begin(), line.index.begin() + line.count,
+                             [attrs](const ubyte a, const ubyte b) { return attrs[a * 4 + 1] < attrs[b * 4 + 1]; });
+    }
+
+    dirty = false;
+    tall = tall_objects;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "lcd_registers.hpp"
+#include <types.hpp>
+#include <array>
+
+class Oam;
+
+// Objects on a line, in drawing priority order: lower X first on DMG
+// (OAM order on ties), plain OAM order on CGB
+struct ObjectLine
+{
+    uint count;
+    std::array<ubyte, 10> index;
+};
+
+// The first ten objects of every visible line, like the OAM scan picks
+// them. OAM writes and DMA mark the table dirty; the whole table is built
+// again the next time a line is looked up, or when the object size changes.
+class ObjectTable
+{
+private:
+    const Oam& oam;
+    bool cgb;
+
+    std::array<ObjectLine, screen_height> lines{};
+    bool dirty;
+    bool tall;              // Object size the table was built for
+
+public:
+    ObjectTable(const Oam& oam, const bool cgb);
+
+    const ObjectLine& line(const uint ly, const bool tall_objects)
+    {
+        if (dirty || tall_objects != tall)
+            rebuild(tall_objects);
+        return lines[ly];
+    }
+
+    void invalidate() { dirty = true; }
+
+private:
+    void rebuild(const bool tall_objects);
+};
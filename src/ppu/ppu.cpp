@@ -0,0 +1,361 @@
+#include "ppu.hpp"
+
+#include "fifo_renderer.hpp"
+#include "scanline_renderer.hpp"
+#include "../utils/hash.hpp"
+#include <algorithm>
+
+Ppu::Ppu(Scheduler& scheduler, Interrupts& irq, Dma& dma, VideoRam& vram, Oam& oam, const bool cgb, const Renderer renderer, const uint render_interval)
+    : scheduler(scheduler), irq(irq), dma(dma), vram(vram), oam(oam), cgb(cgb), mode(MODE_OAM), window_line(0), window_triggered(false), window_on_line(false),
+      stat_line(false), frames(0), draw_start(0), draw_length(0), frame_start(0), next_change(0), first_line(false), catching_up(false),
+      render_interval(render_interval), frame_requested(false), rendering(true), tiles(vram),
+      objects(oam, cgb)
+{
+    vram.attach(&tiles);
+    backend = make_backend(renderer);
+
+    // Palettes as the boot ROM leaves them: white for CGB games, a gray
+    // ramp in the first palettes for DMG games
+    regs.bg_colors.fill(0x7FFF);
+    regs.obj_colors.fill(0x7FFF);
+    if (!cgb)
+    {
+        constexpr ushort grays[4] = { 0x7FFF, 0x56B5, 0x294A, 0x0000 };
+        for (uint i = 0; i < 4; i++)
+            regs.bg_colors[i] = regs.obj_colors[i] = regs.obj_colors[4 + i] = grays[i];
+    }
+
+    scheduler.on(PPU, [this](ulong) { catch_up(); reschedule(); });
+    dma.on_hblank_armed([this] { catch_up(); reschedule(); });
+    vram.on_write([this] { catch_up(); });
+    oam.on_write([this] { catch_up(); objects.invalidate(); });
+
+    start_frame(scheduler.now());
+    reschedule();
+}
+
+bool Ppu::accepts(const ushort addr) const
+{
+    return (addr >= 0xFF40 && addr <= 0xFF4B && addr != 0xFF46) || (addr >= 0xFF68 && addr <= 0xFF6B);
+}
+
+ubyte Ppu::read(const ushort addr) const
+{
+    if (addr == 0xFF41 || addr == 0xFF44)
+        const_cast<Ppu*>(this)->catch_up();
+
+    switch (addr)
+    {
+        case 0xFF40: return regs.lcdc;
+        case 0xFF41: return 0x80 | regs.stat | (regs.ly == regs.lyc ? 0x04 : 0x00) | stat_mode();
+        case 0xFF42: return regs.scy;
+        case 0xFF43: return regs.scx;
+        case 0xFF44: return regs.ly;
+        case 0xFF45: return regs.lyc;
+        case 0xFF47: return regs.bgp;
+        case 0xFF48: return regs.obp0;
+        case 0xFF49: return regs.obp1;
+        case 0xFF4A: return regs.wy;
+        case 0xFF4B: return regs.wx;
+        case 0xFF68: return 0x40 | regs.bcps;
+        case 0xFF69: return read_palette(regs.bcps, regs.bg_colors);
+        case 0xFF6A: return 0x40 | regs.ocps;
+        case 0xFF6B: return read_palette(regs.ocps, regs.obj_colors);
+        default: return 0xFF;
+    }
+}
+
+void Ppu::write(const ushort addr, const ubyte value)
+{
+    // Pixels up to now are drawn with the old value
+    catch_up();
+
+    switch (addr)
+    {
+        case 0xFF40:
+        {
+            const bool was_enabled = regs.enabled();
+            regs.lcdc = value;
+
+            // The screen goes blank while the LCD is off and stays blank
+            // for the first frame after it is turned back on, whose first
+            // line skips the OAM scan
+            if (was_enabled && !regs.enabled())
+            {
+                regs.ly = 0;
+                mode = MODE_HBLANK;
+                window_line = 0;
+                window_triggered = false;
+                output.back().fill(0x7FFF);
+                if (shadow)
+                    shadow_frames.front().fill(0x7FFF);
+                publish_frame();
+            }
+            else if (!was_enabled && regs.enabled())
+            {
+                start_frame(scheduler.now(), false);
+                first_line = true;
+            }
+            break;
+        }
+        case 0xFF41: regs.stat = value & 0x78; break;
+        case 0xFF42: regs.scy = value; break;
+        case 0xFF43: regs.scx = value; break;
+        case 0xFF45: regs.lyc = value; break;
+        case 0xFF47: regs.bgp = value; break;
+        case 0xFF48: regs.obp0 = value; break;
+        case 0xFF49: regs.obp1 = value; break;
+        case 0xFF4A: regs.wy = value; break;
+        case 0xFF4B: regs.wx = value; break;
+        case 0xFF68: regs.bcps = value & 0xBF; break;
+        case 0xFF69: write_palette(regs.bcps, regs.bg_colors, value); break;
+        case 0xFF6A: regs.ocps = value & 0xBF; break;
+        case 0xFF6B: write_palette(regs.ocps, regs.obj_colors, value); break;
+        default: break;
+    }
+
+    update_stat();
+    reschedule();
+}
+
+void Ppu::save_state(StateWriter& state) const
+{
+    state.value(regs);
+    state.value(mode);
+    state.value(window_line);
+    state.value(window_triggered);
+    state.value(window_on_line);
+    state.value(stat_line);
+    state.value(frames);
+    state.value(draw_start);
+    state.value(draw_length);
+    state.value(frame_start);
+    state.value(next_change);
+    state.value(first_line);
+}
+
+void Ppu::load_state(StateReader& state)
+{
+    state.value(regs);
+    state.value(mode);
+    state.value(window_line);
+    state.value(window_triggered);
+    state.value(window_on_line);
+    state.value(stat_line);
+    state.value(frames);
+    state.value(draw_start);
+    state.value(draw_length);
+    state.value(frame_start);
+    state.value(next_change);
+    state.value(first_line);
+
+    objects.invalidate();
+
+    // A line in progress is drawn again from its start on the next catch-up
+    if (mode == MODE_DRAW && regs.enabled() && rendering)
+        draw_line();
+}
+
+void Ppu::add_shadow(const Renderer renderer)
+{
+    shadow = make_backend(renderer);
+    shadow_frames.assign(2, Framebuffer{});
+}
+
+std::unique_ptr<PpuBackend> Ppu::make_backend(const Renderer renderer)
+{
+    if (renderer == Renderer::PIXEL_FIFO)
+        return std::make_unique<FifoRenderer>(vram, oam, tiles, objects, cgb);
+    return std::make_unique<ScanlineRenderer>(vram, oam, tiles, objects, cgb);
+}
+
+// Starts drawing line regs.ly with the backend, and the shadow if any
+LineTiming Ppu::draw_line()
+{
+    if (shadow)
+        shadow->start_line(regs, window_line, window_triggered, shadow_frames.front().data() + regs.ly * screen_width);
+    return backend->start_line(regs, window_line, window_triggered, output.back().data() + regs.ly * screen_width);
+}
+
+void Ppu::publish_frame()
+{
+    output.publish();
+    if (shadow)
+        shadow_frames.back() = shadow_frames.front();
+}
+
+void Ppu::catch_up()
+{
+    // HBlank DMA writes VRAM from inside advance
+    if (catching_up || !regs.enabled())
+        return;
+
+    catching_up = true;
+
+    const ulong now = scheduler.now();
+    while (next_change <= now)
+        advance();
+
+    if (mode == MODE_DRAW && rendering)
+    {
+        backend->sync(regs, now - draw_start);
+        if (shadow)
+            shadow->sync(regs, now - draw_start);
+    }
+
+    catching_up = false;
+}
+
+ulong Ppu::frame_hash() const
+{
+    return hash_bytes(reinterpret_cast<const ubyte*>(frame().data()), sizeof(Framebuffer));
+}
+
+void Ppu::advance()
+{
+    const ulong when = next_change;
+
+    switch (mode)
+    {
+        case MODE_OAM:
+        {
+            mode = MODE_DRAW;
+            first_line = false;
+            draw_start = when;
+
+            const LineTiming timing = rendering ? draw_line() : backend->measure_line(regs, window_triggered);
+            draw_length = timing.length;
+            window_on_line = timing.window;
+            next_change = when + draw_length;
+            break;
+        }
+
+        case MODE_DRAW:
+            // Counted on every line, drawn or not, as it is machine state
+            if (rendering)
+            {
+                backend->finish_line(regs);
+                if (shadow)
+                    shadow->finish_line(regs);
+            }
+            if (window_on_line)
+                window_line++;
+
+            mode = MODE_HBLANK;
+            next_change = when + line_cycles - oam_cycles - draw_length;
+            dma.hblank();
+            break;
+
+        case MODE_HBLANK:
+            if (++regs.ly == screen_height)
+            {
+                mode = MODE_VBLANK;
+                irq.IF_VBLANK = 1;
+                frames++;
+
+                if (rendering)
+                    publish_frame();
+                next_change = when + line_cycles;
+            }
+            else
+                start_line(when);
+            break;
+
+        case MODE_VBLANK:
+            if (++regs.ly == 154)
+            {
+                regs.ly = 0;
+                window_line = 0;
+                window_triggered = false;
+                start_frame(when);
+            }
+            else
+                next_change = when + line_cycles;
+            break;
+    }
+
+    update_stat();
+}
+
+void Ppu::start_frame(const ulong when, const bool shown)
+{
+    rendering = shown && (frame_requested || (render_interval && frames % render_interval == 0));
+    if (rendering)
+        frame_requested = false;
+
+    frame_start = when;
+    start_line(when);
+}
+
+void Ppu::start_line(const ulong when)
+{
+    if (regs.ly == regs.wy)
+        window_triggered = true;
+
+    mode = MODE_OAM;
+    next_change = when + oam_cycles;
+}
+
+// VBlank is always raised on time, since IF can be polled without touching
+// the LCD. Mode interrupts and HBlank DMA need every mode change; the LYC
+// interrupt only the start of its line.
+void Ppu::reschedule()
+{
+    if (!regs.enabled())
+    {
+        scheduler.cancel(PPU);
+        return;
+    }
+
+    ulong when = frame_start + (regs.ly < screen_height ? screen_height : 154 + screen_height) * line_cycles;
+
+    if ((regs.stat & 0x38) || dma.hblank_pending())
+        when = next_change;
+    else if ((regs.stat & 0x40) && regs.lyc < 154)
+    {
+        ulong lyc_line = frame_start + regs.lyc * line_cycles;
+        if (lyc_line <= scheduler.now())
+            lyc_line += frame_cycles;
+        when = std::min(when, lyc_line);
+    }
+
+    scheduler.schedule(PPU, when);
+}
+
+LcdMode Ppu::stat_mode() const
+{
+    if (!regs.enabled() || (first_line && mode == MODE_OAM))
+        return MODE_HBLANK;
+    return mode;
+}
+
+// The STAT interrupt fires when any enabled condition becomes true while
+// none was
+void Ppu::update_stat()
+{
+    const LcdMode mode = stat_mode();
+    const bool line = regs.enabled() &&
+        (((regs.stat & 0x40) && regs.ly == regs.lyc) ||
+         ((regs.stat & 0x08) && mode == MODE_HBLANK) ||
+         ((regs.stat & 0x10) && mode == MODE_VBLANK) ||
+         ((regs.stat & 0x20) && mode == MODE_OAM));
+
+    if (line && !stat_line)
+        irq.IF_LCDC = 1;
+    stat_line = line;
+}
+
+void Ppu::write_palette(ubyte& index, std::array<ushort, 32>& colors, const ubyte value)
+{
+    ushort& color = colors[(index & 0x3F) >> 1];
+    color = (index & 1) ? (color & 0x00FF) | (value & 0x7F) << 8 : (color & 0xFF00) | value;
+
+    if (index & 0x80)
+        index = 0x80 | ((index + 1) & 0x3F);
+}
+
+ubyte Ppu::read_palette(const ubyte index, const std::array<ushort, 32>& colors) const
+{
+    const ushort color = colors[(index & 0x3F) >> 1];
+    return (index & 1) ? color >> 8 : color & 0xFF;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "lcd_registers.hpp"
+#include "object_table.hpp"
+#include "ppu_backend.hpp"
+#include "tile_cache.hpp"
+#include "../cpu/interrupts.hpp"
+#include "../memory/dma.hpp"
+#include "../memory/memory_unit.hpp"
+#include "../scheduler/scheduler.hpp"
+#include "../state/state.hpp"
+#include "../utils/triple_buffer.hpp"
+#include <memory>
+#include <vector>
+
+// LCD controller: registers 0xFF40-0xFF4B (except DMA at 0xFF46) and the
+// CGB palette ports 0xFF68-0xFF6B. Pixels come from the backend chosen at
+// construction, which also decides how long mode 3 lasts.
+//
+// The LCD runs behind the CPU on the master clock, which is unaffected by
+// double speed. It only catches up when its state can be observed or
+// changed: LY/STAT reads, writes to its registers, VRAM or OAM, and the PPU
+// event. That event is only scheduled when something must happen on time:
+// VBlank, an enabled STAT source, or a pending HBlank DMA. While the LCD
+// is off there is no event at all, LY stays at 0 and STAT reads mode 0.
+class Ppu : public MemoryUnit
+{
+private:
+    Scheduler& scheduler;
+    Interrupts& irq;
+    Dma& dma;
+    const VideoRam& vram;
+    const Oam& oam;
+    bool cgb;
+
+    LcdRegisters regs;
+    LcdMode mode;
+    uint window_line;
+    bool window_triggered;
+    bool window_on_line;    // The window shows on the line being drawn
+    bool stat_line;
+    ulong frames;
+    ulong draw_start;
+    ulong draw_length;
+    ulong frame_start;      // Start of line 0 of the current frame
+    ulong next_change;      // Next mode change
+    bool first_line;        // Line 0 right after the LCD is turned on
+    bool catching_up;
+
+    // Host settings, not part of the machine state
+    uint render_interval;
+    bool frame_requested;
+    bool rendering;         // Whether the current frame is drawn
+
+    TileCache tiles;
+    ObjectTable objects;
+    std::unique_ptr<PpuBackend> backend;
+    TripleBuffer<Framebuffer> output;      // Lines are drawn into the back frame
+
+    // Second backend drawn on the first one's timing; see add_shadow
+    std::unique_ptr<PpuBackend> shadow;
+    std::vector<Framebuffer> shadow_frames;     // Frame being drawn, last complete frame
+
+public:
+    static constexpr ulong oam_cycles = 80;
+    static constexpr ulong line_cycles = 456;
+    static constexpr ulong frame_cycles = 154 * line_cycles;
+
+    Ppu(Scheduler& scheduler, Interrupts& irq, Dma& dma, VideoRam& vram, Oam& oam, const bool cgb,
+        const Renderer renderer = Renderer::SCANLINE, const uint render_interval = 1);
+
+    bool accepts(const ushort addr) const override;
+    ubyte read(const ushort addr) const override;
+    void write(const ushort addr, const ubyte value) override;
+
+    // Runs every mode change up to now, drawing the lines they complete
+    void catch_up();
+
+    // Draws one frame in `interval` from the next one on, or none for 0.
+    // Timing, STAT and interrupts are the same either way; frame() stays
+    // on the last frame drawn.
+    void render_every(const uint interval) { render_interval = interval; }
+    // Draws the next frame whatever the interval
+    void request_frame() { frame_requested = true; }
+    bool renders_frame() const { return rendering; }
+
+    // Last complete frame, published at the start of VBlank
+    const Framebuffer& frame() const { return output.latest(); }
+
+    // Completed frames for a display, encoder or agent thread, which calls
+    // update() and reads front(); the emulation never waits on it
+    TripleBuffer<Framebuffer>& frame_output() { return output; }
+    ulong frame_count() const { return frames; }
+    ulong frame_hash() const;
+
+    TileCache& tile_cache() { return tiles; }
+
+    // Also draws every drawn line with another backend, fed the same
+    // registers at the same dots, so the two can be compared frame by frame
+    // without their mode 3 lengths changing the machine's timing
+    void add_shadow(const Renderer renderer);
+    // Last complete frame of the shadow backend; only after add_shadow
+    const Framebuffer& shadow_frame() const { return shadow_frames.back(); }
+
+    void save_state(StateWriter& state) const;
+    void load_state(StateReader& state);
+
+private:
+    std::unique_ptr<PpuBackend> make_backend(const Renderer renderer);
+    LineTiming draw_line();
+    void publish_frame();
+    void advance();
+    void start_frame(const ulong when, const bool shown = true);
+    void start_line(const ulong when);
+    LcdMode stat_mode() const;
+    void update_stat();
+    void reschedule();
+
+    void write_palette(ubyte& index, std::array<ushort, 32>& colors, const ubyte value);
+    ubyte read_palette(const ubyte index, const std::array<ushort, 32>& colors) const;
+};
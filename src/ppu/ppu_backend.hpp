@@ -0,0 +1,38 @@
+#pragma once
+
+#include "lcd_registers.hpp"
+
+enum class Renderer
+{
+    SCANLINE,   // Whole line at the end of mode 3, which has a fixed length
+    PIXEL_FIFO  // Dot by dot, with mode 3 stretched by scrolling, window and objects
+};
+
+// Mode 3 of one line as the backend will run it
+struct LineTiming
+{
+    ulong length;   // In dots
+    bool window;    // Whether the window shows on the line, which advances its line counter
+};
+
+// Draws the pixels of a line for the Ppu, which owns the registers and the
+// mode timing. A line is started when mode 3 begins and finished when it
+// ends; in between, the Ppu syncs the backend whenever it catches up, which
+// includes right before every register write.
+class PpuBackend
+{
+public:
+    virtual ~PpuBackend() = default;
+
+    // Line regs.ly is drawn into `out`
+    virtual LineTiming start_line(const LcdRegisters& regs, const uint window_line, const bool window_triggered, ushort* out) = 0;
+
+    // Same timing as start_line, for lines that are not drawn
+    virtual LineTiming measure_line(const LcdRegisters& regs, const bool window_triggered) = 0;
+
+    // Mode 3 has run for `dot` dots with these registers, which may change next
+    virtual void sync(const LcdRegisters& regs, const ulong dot) {}
+
+    // Mode 3 has ended
+    virtual void finish_line(const LcdRegisters& regs) = 0;
+};
@@ -0,0 +1,146 @@
+#include "scanline_renderer.hpp"
+
+#include <algorithm>
+
+ScanlineRenderer::ScanlineRenderer(const VideoRam& vram, const Oam& oam, TileCache& tiles, ObjectTable& objects, const bool cgb)
+    : fetcher(vram, oam, tiles, objects, cgb), window_line(0), window_triggered(false), window_x(screen_width), window_skip(0),
+      lead(0), window_delay(0), out(nullptr)
+{
+    spans.reserve(16);
+}
+
+LineTiming ScanlineRenderer::start_line(const LcdRegisters& regs, const uint window_line, const bool window_triggered, ushort* out)
+{
+    this->window_line = window_line;
+    this->window_triggered = window_triggered;
+    this->out = out;
+    window_x = screen_width;
+    window_skip = 0;
+
+    // Same pixel timing as the FIFO without objects or the window
+    lead = draw_cycles - screen_width + (regs.scx & 7);
+    window_delay = 0;
+    spans.clear();
+    return measure_line(regs, window_triggered);
+}
+
+void ScanlineRenderer::sync(const LcdRegisters& regs, const ulong dot)
+{
+    if (dot <= lead)
+        return;
+
+    // Pixels after the window start come out later, as from the FIFO
+    const ulong x = dot - lead;
+    uint begin = spans.empty() ? 0 : spans.back().end;
+    const uint window_start = std::max<uint>(begin, std::max(int(regs.wx) - 7, 0));
+    if (!window_delay && fetcher.shows_window(regs, window_triggered) && window_start < x)
+    {
+        window_delay = window_dots + (regs.wx < 7 ? 7 - regs.wx : 0);
+        begin = window_start;
+    }
+
+    log(regs, std::min<ulong>(std::max<ulong>(begin, x > window_delay ? x - window_delay : 0), screen_width));
+}
+
+void ScanlineRenderer::finish_line(const LcdRegisters& regs)
+{
+    log(regs, screen_width);
+
+    const uint fine_x = spans.front().regs.scx & 7;
+
+    uint begin = 0;
+    for (const Span& span : spans)
+    {
+        if (span.end > begin)
+            render(span.regs, fine_x, begin, span.end);
+        begin = span.end;
+    }
+}
+
+void ScanlineRenderer::log(const LcdRegisters& regs, const uint x)
+{
+    if (!spans.empty() && spans.back().regs == regs)
+        spans.back().end = x;
+    else
+        spans.push_back({ x, regs });
+}
+
+// Draws pixels [begin, end) of the line, fetching the background tiles
+// whose first pixel falls in it. With the background off those tiles come
+// out blank, as from the FIFO, and a tile fetched by an earlier span keeps
+// its pixels.
+void ScanlineRenderer::render(const LcdRegisters& regs, const uint fine_x, const uint begin, const uint end)
+{
+    const bool draw_bg = fetcher.draws_bg(regs);
+
+    const uint y = (regs.scy + regs.ly) & 0xFF;
+    for (uint i = begin ? (begin + fine_x + 7) / 8 : 0; i * 8 < end + fine_x; i++)
+    {
+        if (draw_bg)
+            fetcher.map_tile(bg.data() + i * 8, regs, regs.bg_map_high(), (regs.scx >> 3) + i, y);
+        else
+            std::fill_n(bg.data() + i * 8, 8, 0);
+    }
+
+    // The window takes over from WX - 7, or from the first pixel of a later
+    // span that shows it, to the end of the line, like on the FIFO
+    if (window_x == screen_width && fetcher.shows_window(regs, window_triggered))
+    {
+        const uint start = std::max<uint>(begin, std::max(int(regs.wx) - 7, 0));
+        if (start < end)
+        {
+            window_x = start;
+            window_skip = regs.wx < 7 ? 7 - regs.wx : 0;
+        }
+    }
+
+    // Window tiles are counted from its left edge and fetched like the
+    // background ones
+    if (window_x < end)
+    {
+        const uint first = begin > window_x ? (begin - window_x + window_skip + 7) / 8 : 0;
+        for (uint i = first; i * 8 < end - window_x + window_skip; i++)
+        {
+            if (draw_bg)
+                fetcher.map_tile(window.data() + i * 8, regs, regs.window_map_high(), i, window_line);
+            else
+                std::fill_n(window.data() + i * 8, 8, 0);
+        }
+    }
+
+    std::fill(obj_line.begin(), obj_line.end(), 0);
+    if (regs.objects_enabled())
+        render_objects(regs);
+
+    const ubyte* line = bg.data() + fine_x;
+    const uint split = std::clamp(window_x, begin, end);
+    for (uint x = begin; x < split; x++)
+        out[x] = fetcher.mix(regs, line[x], obj_line[x]);
+    for (uint x = split; x < end; x++)
+        out[x] = fetcher.mix(regs, window[x - window_x + window_skip], obj_line[x]);
+}
+
+void ScanlineRenderer::render_objects(const LcdRegisters& regs)
+{
+    const ubyte* attrs = fetcher.attributes();
+
+    const ObjectLine& selected = fetcher.select_objects(regs);
+    const int n_selected = selected.count;
+
+    for (int n = 0; n < n_selected; n++)
+        fetcher.object_row(objects.data() + n * 8, regs, selected.index[n]);
+
+    // Drawn back to front
+    for (int n = n_selected - 1; n >= 0; n--)
+    {
+        const int left = int(attrs[selected.index[n] * 4 + 1]) - 8;
+        const ubyte* pixels = objects.data() + n * 8;
+
+        for (int i = 0; i < 8; i++)
+        {
+            const int x = left + i;
+            if (x >= 0 && x < int(screen_width) && (pixels[i] & 3))
+                obj_line[x] = pixels[i] | TileFetcher::obj_opaque;
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "ppu_backend.hpp"
+#include "tile_fetcher.hpp"
+
+#include <vector>
+
+// Draws a whole line in one go when mode 3 ends. Tile rows come pre-decoded
+// from the tile cache, so the background, window and objects are gathered
+// eight pixels at a time; only the final mix goes pixel by pixel.
+//
+// Register writes during mode 3 are logged with the pixel they land on, and
+// each span between two writes is drawn with the registers it saw, the way
+// the FIFO would: fine scroll is taken at the start of the line, the
+// scroll position whenever a tile is fetched, and the rest per pixel. The
+// window has its own buffer and, once started, holds the rest of the line.
+class ScanlineRenderer : public PpuBackend
+{
+private:
+    TileFetcher fetcher;
+
+    static constexpr uint max_tiles = 21;
+    static constexpr uint window_dots = 6;      // Stall when the window starts, as on the FIFO
+
+    std::array<ubyte, max_tiles * 8> bg{};
+    std::array<ubyte, max_tiles * 8> window{};
+    std::array<ubyte, 10 * 8> objects{};
+    std::array<ubyte, screen_width> obj_line{};
+
+    // Registers in effect up to pixel `end`
+    struct Span
+    {
+        uint end;
+        LcdRegisters regs;
+    };
+
+    std::vector<Span> spans;
+
+    uint window_line;
+    bool window_triggered;
+    uint window_x;      // First pixel taken from the window, screen_width until it starts
+    uint window_skip;   // Window pixels hidden left of the screen
+    uint lead;          // Dots before the first pixel is out
+    uint window_delay;  // Dots the window start has held the pixels back, once it is seen
+    ushort* out;
+
+public:
+    static constexpr ulong draw_cycles = 172;
+
+    ScanlineRenderer(const VideoRam& vram, const Oam& oam, TileCache& tiles, ObjectTable& objects, const bool cgb);
+
+    LineTiming start_line(const LcdRegisters& regs, const uint window_line, const bool window_triggered, ushort* out) override;
+    LineTiming measure_line(const LcdRegisters& regs, const bool window_triggered) override
+    {
+        return { draw_cycles, fetcher.shows_window(regs, window_triggered) };
+    }
+    void sync(const LcdRegisters& regs, const ulong dot) override;
+    void finish_line(const LcdRegisters& regs) override;
+
+private:
+    void log(const LcdRegisters& regs, const uint x);
+    void render(const LcdRegisters& regs, const uint fine_x, const uint begin, const uint end);
+    void render_objects(const LcdRegisters& regs);
+};
@@ -0,0 +1,18 @@
+#include "tile_cache.hpp"
+
+#include "../memory/video_ram.hpp"
+
+TileCache::TileCache(const VideoRam& vram) : vram(vram), hit_count(0), miss_count(0)
+{
+    invalidate_all();
+}
+
+void TileCache::refill(const uint index)
+{
+    const uint bank = index / (n_tiles * 8);
+    const ubyte* data = vram.data(bank) + (index % (n_tiles * 8)) * 2;
+
+    decode_tile_row(data[0], data[1], rows[index].data());
+    dirty[index >> 6] &= ~(1ull << (index & 63));
+    miss_count++;
+}
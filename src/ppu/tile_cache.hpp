@@ -0,0 +1,61 @@
+#pragma once
+
+#include "tile_decode.hpp"
+#include <types.hpp>
+#include <array>
+
+class VideoRam;
+
+// Every tile row of both VRAM banks decoded to one color index per pixel,
+// in both orientations. VRAM writes mark single rows dirty; a dirty row is
+// decoded again the next time it is looked up.
+class TileCache
+{
+public:
+    static constexpr uint n_tiles = 384;
+    static constexpr uint n_rows = 2 * n_tiles * 8;
+
+private:
+    const VideoRam& vram;
+
+    alignas(64) std::array<std::array<ubyte, 16>, n_rows> rows{};
+    std::array<ulong, n_rows / 64> dirty;
+
+    ulong hit_count;
+    ulong miss_count;
+
+public:
+    explicit TileCache(const VideoRam& vram);
+
+    // Eight color indices of `row` of `tile` (its VRAM offset / 16)
+    const ubyte* row(const uint bank, const uint tile, const uint row, const bool mirrored)
+    {
+        const uint index = (bank * n_tiles + tile) * 8 + row;
+
+        if ((dirty[index >> 6] >> (index & 63)) & 1)
+            refill(index);
+        else
+            hit_count++;
+
+        return rows[index].data() + (mirrored ? 8 : 0);
+    }
+
+    // `offset` is relative to 0x8000; writes to the tile maps are ignored
+    void invalidate(const uint bank, const ushort offset)
+    {
+        if (offset < 0x1800)
+        {
+            const uint index = bank * n_tiles * 8 + (offset >> 1);
+            dirty[index >> 6] |= 1ull << (index & 63);
+        }
+    }
+
+    void invalidate_all() { dirty.fill(~0ull); }
+
+    ulong hits() const { return hit_count; }
+    ulong misses() const { return miss_count; }
+    void reset_counters() { hit_count = miss_count = 0; }
+
+private:
+    void refill(const uint index);
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <types.hpp>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <utils/bit_utils.hpp>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+// Expands one 2bpp tile row into 16 bytes: the eight 2-bit colors leftmost
+// pixel first, followed by the same row mirrored.
+inline void decode_tile_row(const ubyte lo, const ubyte hi, ubyte* out) noexcept
+{
+    #if defined(__SSE2__)
+        // Lane i of the first half keeps bit 7 - i, of the second half bit i
+        const __m128i bits = _mm_set_epi8((char)0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+                                          0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, (char)0x80);
+        const __m128i one = _mm_set1_epi8(1);
+
+        const __m128i l = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(_mm_set1_epi8(lo), bits), bits), one);
+        const __m128i h = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(_mm_set1_epi8(hi), bits), bits), _mm_add_epi8(one, one));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_or_si128(l, h));
+    #else
+        // Multiplying copies the byte into every lane; lane i keeps bit i,
+        // which after the reversal is pixel i
+        auto spread = [](const ubyte b)
+        {
+            const ulong lanes = (ulong(_reversed[b]) * 0x0101010101010101ull) & 0x8040201008040201ull;
+            return ((lanes + 0x7F7F7F7F7F7F7F7Full) >> 7) & 0x0101010101010101ull;
+        };
+
+        ulong pixels = spread(lo) | spread(hi) << 1;
+        #if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            pixels = swap_bytes(pixels);
+        #endif
+        const ulong mirrored = swap_bytes(pixels);
+
+        std::memcpy(out, &pixels, 8);
+        std::memcpy(out + 8, &mirrored, 8);
+    #endif
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "lcd_registers.hpp"
+#include "object_table.hpp"
+#include "tile_cache.hpp"
+#include "../memory/oam.hpp"
+#include "../memory/video_ram.hpp"
+
+#include <array>
+#include <cstring>
+
+// Fetching and mixing shared by the PPU backends, so they only differ in
+// when things happen.
+//
+// Line pixels carry the color in bits 0-1 and the palette in bits 2-4.
+// Background pixels keep the CGB priority attribute in bit 5, object
+// pixels their behind-background flag in bit 5 and an opaque flag in bit 6.
+class TileFetcher
+{
+public:
+    static constexpr ubyte bg_priority = 0x20;
+    static constexpr ubyte obj_behind = 0x20;
+    static constexpr ubyte obj_opaque = 0x40;
+
+private:
+    const VideoRam& vram;
+    const Oam& oam;
+    TileCache& tiles;
+    ObjectTable& objects;
+    bool cgb;
+
+public:
+    TileFetcher(const VideoRam& vram, const Oam& oam, TileCache& tiles, ObjectTable& objects, const bool cgb)
+        : vram(vram), oam(oam), tiles(tiles), objects(objects), cgb(cgb)
+    {}
+
+    bool cgb_mode() const { return cgb; }
+    const ubyte* attributes() const { return oam.data(); }
+
+    // On DMG-compatible carts LCDC bit 0 blanks the background and window
+    bool draws_bg(const LcdRegisters& regs) const { return cgb || regs.bg_enabled(); }
+
+    // The window has reached this line and is on screen
+    bool shows_window(const LcdRegisters& regs, const bool window_triggered) const
+    {
+        return draws_bg(regs) && regs.window_enabled() && window_triggered && regs.wx <= 166;
+    }
+
+    // Eight pixels of map line y at map column `column`
+    void map_tile(ubyte* out, const LcdRegisters& regs, const bool high_map, const uint column, const uint y) const
+    {
+        const uint offset = (high_map ? 0x1C00 : 0x1800) + ((y >> 3) & 31) * 32 + (column & 31);
+        const ubyte tile = vram.data(0)[offset];
+        const ubyte attr = cgb ? vram.data(1)[offset] : 0;
+
+        const uint row = (attr & 0x40) ? 7 - (y & 7) : (y & 7);
+        const uint index = regs.unsigned_tiles() ? tile : 256 + byte(tile);
+
+        gather(out, (attr >> 3) & 1, index, row, attr & 0x20, ((attr & 0x07) << 2) | (attr & 0x80 ? bg_priority : 0));
+    }
+
+    // The first ten objects on line regs.ly, in drawing priority order
+    const ObjectLine& select_objects(const LcdRegisters& regs) const
+    {
+        return objects.line(regs.ly, regs.tall_objects());
+    }
+
+    // Eight pixels of object `index` on line regs.ly, leftmost first
+    void object_row(ubyte* out, const LcdRegisters& regs, const uint index) const
+    {
+        const uint height = regs.tall_objects() ? 16 : 8;
+        const ubyte* obj = oam.data() + index * 4;
+        const ubyte flags = obj[3];
+
+        uint row = regs.ly - (obj[0] - 16);
+        if (flags & 0x40)
+            row = height - 1 - row;
+
+        // Tall objects span two consecutive tiles
+        const uint tile = ((height == 16) ? (obj[2] & 0xFE) : obj[2]) + (row >> 3);
+        const ubyte palette = cgb ? (flags & 0x07) : ((flags >> 4) & 1);
+
+        gather(out, cgb ? (flags >> 3) & 1 : 0, tile, row & 7, flags & 0x20, (palette << 2) | (flags & 0x80 ? obj_behind : 0));
+    }
+
+    // Final color from a background/window pixel and an object pixel
+    ushort mix(const LcdRegisters& regs, const ubyte b, const ubyte o) const
+    {
+        bool show_obj = o & obj_opaque;
+        if (show_obj && (b & 3))
+        {
+            // CGB: LCDC bit 0 off gives objects priority over everything
+            if (cgb)
+                show_obj = !regs.bg_enabled() || !((b | o) & bg_priority);
+            else
+                show_obj = !(o & obj_behind);
+        }
+
+        if (show_obj)
+            return cgb ? regs.obj_colors[o & 0x1F]
+                       : regs.obj_colors[(o & 0x04) + ((((o & 0x04) ? regs.obp1 : regs.obp0) >> ((o & 3) * 2)) & 3)];
+
+        return cgb ? regs.bg_colors[b & 0x1F] : regs.bg_colors[(regs.bgp >> ((b & 3) * 2)) & 3];
+    }
+
+private:
+    // Copies eight decoded pixels with the tag ORed into each
+    void gather(ubyte* out, const uint bank, const uint tile, const uint row, const bool mirrored, const ubyte tag) const
+    {
+        ulong pixels;
+        std::memcpy(&pixels, tiles.row(bank, tile, row, mirrored), 8);
+        pixels |= tag * 0x0101010101010101ull;
+        std::memcpy(out, &pixels, 8);
+    }
+};
@@ -0,0 +1,115 @@
+#include "scheduler.hpp"
+
+void Scheduler::on(const Event event, std::function<void(ulong)> handler)
+{
+    slots[event].handler = std::move(handler);
+}
+
+void Scheduler::schedule(const Event event, const ulong when)
+{
+    Slot& slot = slots[event];
+    slot.cpu_clock = false;
+    slot.when = when;
+
+    if (when < next)
+        next = when;
+    else
+        update_next();
+}
+
+void Scheduler::schedule_cpu(const Event event, const ulong cpu_when)
+{
+    Slot& slot = slots[event];
+    slot.cpu_clock = true;
+    slot.cpu_when = cpu_when;
+    slot.when = to_master(cpu_when);
+
+    if (slot.when < next)
+        next = slot.when;
+    else
+        update_next();
+}
+
+void Scheduler::cancel(const Event event)
+{
+    const ulong when = slots[event].when;
+    slots[event].when = never;
+    if (when == next)
+        update_next();
+}
+
+void Scheduler::switch_speed()
+{
+    switch_armed = false;
+    speed_shift ^= 1;
+
+    for (auto& slot : slots)
+        if (slot.cpu_clock && slot.when != never)
+            slot.when = to_master(slot.cpu_when);
+    update_next();
+}
+
+ulong Scheduler::to_master(const ulong cpu_when) const
+{
+    return cycles + (cpu_when > cpu_cycles ? (cpu_when - cpu_cycles) >> speed_shift : 0);
+}
+
+void Scheduler::dispatch()
+{
+    // Handlers may schedule new events, including ones already due
+    while (next <= cycles)
+    {
+        uint due = 0;
+        for (uint i = 1; i < EVENT_COUNT; i++)
+            if (slots[i].when < slots[due].when)
+                due = i;
+
+        Slot& slot = slots[due];
+        const ulong when = slot.cpu_clock ? slot.cpu_when : slot.when;
+        slot.when = never;
+        update_next();
+
+        if (slot.handler)
+            slot.handler(when);
+    }
+}
+
+void Scheduler::update_next()
+{
+    next = never;
+    for (const auto& slot : slots)
+        if (slot.when < next)
+            next = slot.when;
+}
+
+
+void Scheduler::save_state(StateWriter& state) const
+{
+    state.value(cycles);
+    state.value(cpu_cycles);
+    state.value(speed_shift);
+    state.value(switch_armed);
+
+    for (const auto& slot : slots)
+    {
+        state.value(slot.when);
+        state.value(slot.cpu_when);
+        state.value(slot.cpu_clock);
+    }
+}
+
+void Scheduler::load_state(StateReader& state)
+{
+    state.value(cycles);
+    state.value(cpu_cycles);
+    state.value(speed_shift);
+    state.value(switch_armed);
+
+    for (auto& slot : slots)
+    {
+        state.value(slot.when);
+        state.value(slot.cpu_when);
+        state.value(slot.cpu_clock);
+    }
+    update_next();
+}
\ No newline at end of file
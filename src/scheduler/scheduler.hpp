@@ -0,0 +1,84 @@
+#pragma once
+
+#include <types.hpp>
+#include <state/state.hpp>
+#include <array>
+#include <functional>
+
+enum Event : uint
+{
+    OAM_DMA,
+    GENERAL_DMA,
+    SPEED_SWITCH,
+    TIMER,
+    SERIAL,
+    JOYPAD,
+    PPU,
+    EVENT_COUNT
+};
+
+// Master clock of the machine, counted in 4.194304 MHz cycles, and the
+// queue of timed events. Each event type has one slot; its handler is set
+// once and receives the timestamp the event was scheduled for.
+//
+// The CPU clock runs at the master rate, or twice as fast in CGB double
+// speed mode. Events scheduled on the CPU clock are converted to master
+// time when scheduled and again when the speed changes, so nothing has to
+// rescale cycle counts while ticking.
+class Scheduler
+{
+private:
+    static constexpr ulong never = ~0ull;
+
+    struct Slot
+    {
+        ulong when{ never };
+        ulong cpu_when{ never };
+        bool cpu_clock{ false };
+        std::function<void(ulong)> handler;
+    };
+
+    ulong cycles{ 0 };
+    ulong cpu_cycles{ 0 };
+    uint speed_shift{ 0 };
+    bool switch_armed{ false };
+
+    ulong next{ never };
+    std::array<Slot, EVENT_COUNT> slots;
+
+public:
+    static constexpr ulong frequency = 4194304;
+
+    ulong now() const { return cycles; }
+    ulong cpu_now() const { return cpu_cycles; }
+
+    // Advances the CPU clock by n cycles
+    void tick(const uint n)
+    {
+        cpu_cycles += n;
+        cycles += n >> speed_shift;
+        if (cycles >= next)
+            dispatch();
+    }
+
+    void on(const Event event, std::function<void(ulong)> handler);
+    void schedule(const Event event, const ulong when);
+    void schedule_cpu(const Event event, const ulong cpu_when);
+    void cancel(const Event event);
+
+    bool pending(const Event event) const { return slots[event].when != never; }
+    ulong when(const Event event) const { return slots[event].when; }
+
+    bool double_speed() const { return speed_shift; }
+    bool speed_switch_armed() const { return switch_armed; }
+    void arm_speed_switch(const bool armed) { switch_armed = armed; }
+    void switch_speed();
+
+    void save_state(StateWriter& state) const;
+    void load_state(StateReader& state);
+
+private:
+    ulong to_master(const ulong cpu_when) const;
+    void dispatch();
+    void update_next();
+};
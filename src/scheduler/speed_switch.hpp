@@ -0,0 +1,33 @@
+#pragma once
+
+#include <memory/memory_unit.hpp>
+#include "scheduler.hpp"
+
+// KEY1 (0xFF4D): arms the CGB speed switch performed by the next STOP.
+// Absent in DMG mode.
+class SpeedSwitch : public MemoryUnit
+{
+private:
+    Scheduler& scheduler;
+    bool cgb_mode;
+
+public:
+    SpeedSwitch(Scheduler& scheduler) : scheduler(scheduler), cgb_mode(true) {}
+
+    void set_cgb_mode(const bool cgb) { cgb_mode = cgb; }
+
+    bool accepts(const ushort addr) const override
+    {
+        return cgb_mode && addr == 0xFF4D;
+    }
+
+    ubyte read(const ushort addr) const override
+    {
+        return 0x7E | (scheduler.double_speed() ? 0x80 : 0x00) | (scheduler.speed_switch_armed() ? 0x01 : 0x00);
+    }
+
+    void write(const ushort addr, const ubyte value) override
+    {
+        scheduler.arm_speed_switch(value & 0x1);
+    }
+};
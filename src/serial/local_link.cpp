@@ -0,0 +1,67 @@
+#include "local_link.hpp"
+
+#include <algorithm>
+
+LocalLink::LocalLink(GameBoy& first, GameBoy& second, const std::optional<ulong> quantum)
+    : first(first), second(second), quantum(quantum)
+{
+    first.serial.connect(this);
+    second.serial.connect(this);
+}
+
+LocalLink::~LocalLink()
+{
+    first.serial.connect(nullptr);
+    second.serial.connect(nullptr);
+}
+
+ubyte LocalLink::exchange(const Serial& from, const ubyte out, const ulong when)
+{
+    GameBoy& peer = (&from == &first.serial) ? second : first;
+    deadline(from).reset();
+
+    if (peer.scheduler.now() < when)
+        peer.run_until(when);
+
+    return peer.serial.receive(out);
+}
+
+void LocalLink::started(const Serial& from, const ulong when)
+{
+    deadline(from) = when;
+}
+
+void LocalLink::cancelled(const Serial& from)
+{
+    deadline(from).reset();
+}
+
+void LocalLink::run_until(const ulong cycles)
+{
+    while (first.scheduler.now() < cycles || second.scheduler.now() < cycles)
+    {
+        const bool first_behind = first.scheduler.now() <= second.scheduler.now();
+        GameBoy& behind = first_behind ? first : second;
+        const GameBoy& ahead = first_behind ? second : first;
+        const std::optional<ulong>& ahead_deadline = first_behind ? second_deadline : first_deadline;
+
+        ulong target = std::min(cycles, ahead.scheduler.now() + step_cycles());
+        if (ahead_deadline)
+            target = std::min(target, std::max(*ahead_deadline, behind.scheduler.now() + 1));
+
+        behind.run_until(target);
+    }
+}
+
+// The transfer that can start soonest is a byte at the faster selected clock
+ulong LocalLink::step_cycles() const
+{
+    if (quantum)
+        return *quantum;
+    return std::min(first.serial.transfer_cycles(), second.serial.transfer_cycles());
+}
+
+std::optional<ulong>& LocalLink::deadline(const Serial& from)
+{
+    return (&from == &first.serial) ? first_deadline : second_deadline;
+}
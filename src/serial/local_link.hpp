@@ -0,0 +1,40 @@
+#pragma once
+
+#include "serial.hpp"
+#include "../gameboy.hpp"
+
+#include <optional>
+
+// Link cable between two machines in the same thread. Each machine runs on
+// its own; when a transfer completes, the peer is brought forward to that
+// time if it is behind, and the bytes are swapped. run_until never runs a
+// machine past the end of a transfer its peer has started, and keeps the two
+// within `quantum` master cycles of each other so a transfer is announced
+// before the peer is past it. By default the quantum is one byte at the
+// faster of the clocks the two machines have selected in SC, so the pair
+// only runs in small steps while a game uses the fast clock.
+class LocalLink : public SerialLink
+{
+private:
+    GameBoy& first;
+    GameBoy& second;
+    std::optional<ulong> quantum;
+
+    // Completion time of the transfer each side has started, if any
+    std::optional<ulong> first_deadline;
+    std::optional<ulong> second_deadline;
+
+public:
+    LocalLink(GameBoy& first, GameBoy& second, const std::optional<ulong> quantum = std::nullopt);
+    ~LocalLink();
+
+    ubyte exchange(const Serial& from, const ubyte out, const ulong when) override;
+    void started(const Serial& from, const ulong when) override;
+    void cancelled(const Serial& from) override;
+
+    void run_until(const ulong cycles);
+
+private:
+    ulong step_cycles() const;
+    std::optional<ulong>& deadline(const Serial& from);
+};
@@ -0,0 +1,83 @@
+#include "serial.hpp"
+
+Serial::Serial(Scheduler& scheduler, Interrupts& irq)
+    : scheduler(scheduler), irq(irq), link(nullptr), sb(0x00), sc(0x00), cgb_mode(true)
+{
+    scheduler.on(SERIAL, [this](ulong) { complete(); });
+}
+
+bool Serial::accepts(const ushort addr) const
+{
+    return addr == 0xFF01 || addr == 0xFF02;
+}
+
+ubyte Serial::read(const ushort addr) const
+{
+    return (addr == 0xFF01) ? sb : ((cgb_mode ? 0x7C : 0x7E) | sc);
+}
+
+void Serial::write(const ushort addr, const ubyte value)
+{
+    if (addr == 0xFF01)
+    {
+        sb = value;
+        return;
+    }
+
+    sc = value & (cgb_mode ? 0x83 : 0x81);
+
+    if (transferring() && internal_clock())
+    {
+        scheduler.schedule_cpu(SERIAL, scheduler.cpu_now() + byte_cycles());
+        if (link)
+            link->started(*this, scheduler.when(SERIAL));
+    }
+    else if (scheduler.pending(SERIAL))
+    {
+        scheduler.cancel(SERIAL);
+        if (link)
+            link->cancelled(*this);
+    }
+}
+
+void Serial::connect(SerialLink* link)
+{
+    this->link = link;
+}
+
+ubyte Serial::receive(const ubyte in)
+{
+    if (!transferring() || internal_clock())
+        return 0xFF;
+
+    const ubyte out = sb;
+    sb = in;
+    sc &= 0x7F;
+    irq.IF_SERIAL = 1;
+    return out;
+}
+
+void Serial::save_state(StateWriter& state) const
+{
+    state.value(sb);
+    state.value(sc);
+}
+
+void Serial::load_state(StateReader& state)
+{
+    state.value(sb);
+    state.value(sc);
+}
+
+// 8192 Hz, or 262144 Hz with the CGB fast clock, on the CPU clock
+ulong Serial::byte_cycles() const
+{
+    return 8 * ((sc & 0x02) ? 16 : 512);
+}
+
+void Serial::complete()
+{
+    sb = link ? link->exchange(*this, sb, scheduler.now()) : 0xFF;
+    sc &= 0x7F;
+    irq.IF_SERIAL = 1;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <memory/memory_unit.hpp>
+#include <cpu/interrupts.hpp>
+#include <scheduler/scheduler.hpp>
+#include <state/state.hpp>
+
+class Serial;
+
+// Other end of the link cable. The side driving the clock calls exchange
+// once per byte, when its transfer completes at master clock time `when`,
+// and gets back the byte shifted in from the peer. started/cancelled tell
+// the link ahead of time that an exchange is coming.
+class SerialLink
+{
+public:
+    virtual ~SerialLink() = default;
+    virtual ubyte exchange(const Serial& from, const ubyte out, const ulong when) = 0;
+    virtual void started(const Serial& from, const ulong when) {}
+    virtual void cancelled(const Serial& from) {}
+};
+
+// SB/SC (0xFF01/0xFF02). A transfer on the internal clock is a single
+// SERIAL event at the end of the byte; the bits are never shifted one by one.
+// The fast clock (SC bit 1) only exists in CGB mode.
+class Serial : public MemoryUnit
+{
+private:
+    Scheduler& scheduler;
+    Interrupts& irq;
+    SerialLink* link;
+
+    ubyte sb;
+    ubyte sc;           // Only the bits that exist; unused ones read as 1
+    bool cgb_mode;
+
+public:
+    Serial(Scheduler& scheduler, Interrupts& irq);
+
+    bool accepts(const ushort addr) const override;
+    ubyte read(const ushort addr) const override;
+    void write(const ushort addr, const ubyte value) override;
+
+    void connect(SerialLink* link);
+    void set_cgb_mode(const bool cgb)
+    {
+        cgb_mode = cgb;
+        if (!cgb_mode)
+            sc &= 0x81;
+    }
+
+    // Length of a byte at the clock SC currently selects, in master cycles
+    ulong transfer_cycles() const { return byte_cycles() >> (scheduler.double_speed() ? 1 : 0); }
+
+    // Byte clocked in by the peer; returns the byte shifted out
+    ubyte receive(const ubyte in);
+
+    bool transferring() const { return sc & 0x80; }
+    bool internal_clock() const { return sc & 0x01; }
+
+    void save_state(StateWriter& state) const;
+    void load_state(StateReader& state);
+
+private:
+    ulong byte_cycles() const;
+    void complete();
+};
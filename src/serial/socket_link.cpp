@@ -0,0 +1,301 @@
+#include "socket_link.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+    struct Endpoint
+    {
+        sockaddr_storage addr{};
+        socklen_t length{ 0 };
+        int family{ AF_UNIX };
+    };
+
+    std::optional<Endpoint> parse_endpoint(const std::string& endpoint)
+    {
+        Endpoint res;
+
+        if (endpoint.rfind("tcp:", 0) == 0)
+        {
+            const int port = std::atoi(endpoint.c_str() + 4);
+            if (port <= 0 || port > 0xFFFF)
+                return std::nullopt;
+
+            auto& in = reinterpret_cast<sockaddr_in&>(res.addr);
+            in.sin_family = AF_INET;
+            in.sin_port = htons(port);
+            in.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            res.length = sizeof(in);
+            res.family = AF_INET;
+            return res;
+        }
+
+        auto& un = reinterpret_cast<sockaddr_un&>(res.addr);
+        if (endpoint.empty() || endpoint.size() >= sizeof(un.sun_path))
+            return std::nullopt;
+
+        un.sun_family = AF_UNIX;
+        std::memcpy(un.sun_path, endpoint.c_str(), endpoint.size() + 1);
+        res.length = sizeof(un);
+        return res;
+    }
+
+    void set_no_delay(const int fd, const int family)
+    {
+        const int on = 1;
+        if (family == AF_INET)
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    }
+}
+
+SocketLink::SocketLink(GameBoy& machine, const ulong slice, const int timeout_ms)
+    : machine(machine), fd(-1), slice(slice), timeout_ms(timeout_ms), origin(0),
+      exchanging(false), timed_out(false), late(0)
+{
+    machine.serial.connect(this);
+}
+
+SocketLink::~SocketLink()
+{
+    machine.serial.connect(nullptr);
+    disconnect();
+}
+
+bool SocketLink::listen(const std::string& endpoint)
+{
+    disconnect();
+
+    const auto target = parse_endpoint(endpoint);
+    if (!target)
+        return false;
+
+    const int server = socket(target->family, SOCK_STREAM, 0);
+    if (server < 0)
+        return false;
+
+    const int on = 1;
+    if (target->family == AF_UNIX)
+        unlink(endpoint.c_str());
+    else
+        setsockopt(server, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+    if (bind(server, reinterpret_cast<const sockaddr*>(&target->addr), target->length) != 0 ||
+        ::listen(server, 1) != 0)
+    {
+        ::close(server);
+        return false;
+    }
+
+    const int client = accept(server, nullptr, nullptr);
+    ::close(server);
+
+    if (target->family == AF_UNIX)
+        unlink(endpoint.c_str());
+
+    if (client < 0)
+        return false;
+
+    start(client, target->family);
+    return true;
+}
+
+bool SocketLink::connect(const std::string& endpoint)
+{
+    disconnect();
+
+    const auto target = parse_endpoint(endpoint);
+    if (!target)
+        return false;
+
+    const int client = socket(target->family, SOCK_STREAM, 0);
+    if (client < 0)
+        return false;
+
+    if (::connect(client, reinterpret_cast<const sockaddr*>(&target->addr), target->length) != 0)
+    {
+        ::close(client);
+        return false;
+    }
+
+    start(client, target->family);
+    return true;
+}
+
+void SocketLink::start(const int socket, const int family)
+{
+    fd = socket;
+    set_no_delay(fd, family);
+
+    origin = machine.scheduler.now();
+    timed_out = false;
+}
+
+ubyte SocketLink::exchange(const Serial& from, const ubyte out, const ulong when)
+{
+    if (!send(MESSAGE_DATA, out, when - origin))
+        return 0xFF;
+
+    // The peer may be sending its own byte at the same time, so keep
+    // answering it while waiting for the reply
+    exchanging = true;
+
+    Message message;
+    while (receive(message, true))
+    {
+        if (message.type == MESSAGE_REPLY)
+        {
+            exchanging = false;
+            return message.data;
+        }
+        handle(message);
+    }
+
+    exchanging = false;
+    return 0xFF;
+}
+
+void SocketLink::started(const Serial& from, const ulong when)
+{
+    send(MESSAGE_START, 0, when - origin);
+}
+
+void SocketLink::cancelled(const Serial& from)
+{
+    send(MESSAGE_CANCEL, 0, machine.scheduler.now() - origin);
+}
+
+void SocketLink::run_until(const ulong cycles)
+{
+    while (machine.scheduler.now() < cycles)
+    {
+        poll(false);
+
+        ulong limit = std::min(cycles, machine.scheduler.now() + slice);
+
+        if (peer_transfer && connected())
+        {
+            if (machine.scheduler.now() >= *peer_transfer)
+            {
+                poll(true);
+                continue;
+            }
+            limit = std::min(limit, *peer_transfer);
+        }
+
+        machine.run_until(limit);
+    }
+}
+
+bool SocketLink::send(const MessageType type, const ubyte data, const ulong time)
+{
+    if (!connected())
+        return false;
+
+    Message message{ time, type, data, {} };
+    const ubyte* bytes = reinterpret_cast<const ubyte*>(&message);
+    size_t sent = 0;
+
+    while (sent < sizeof(message))
+    {
+        const ssize_t n = ::send(fd, bytes + sent, sizeof(message) - sent, MSG_NOSIGNAL);
+        if (n <= 0)
+        {
+            disconnect();
+            return false;
+        }
+        sent += n;
+    }
+    return true;
+}
+
+bool SocketLink::receive(Message& message, const bool wait)
+{
+    if (!connected())
+        return false;
+
+    ubyte* bytes = reinterpret_cast<ubyte*>(&message);
+    size_t received = 0;
+
+    while (received < sizeof(message))
+    {
+        // Once a message has begun, the rest of it is always waited for
+        pollfd ready{ fd, POLLIN, 0 };
+        const int n_ready = ::poll(&ready, 1, (wait || received) ? timeout_ms : 0);
+        if (n_ready == 0 && !wait && !received)
+            return false;
+        if (n_ready <= 0)
+        {
+            timed_out = n_ready == 0;
+            disconnect();
+            return false;
+        }
+
+        const ssize_t n = recv(fd, bytes + received, sizeof(message) - received, 0);
+        if (n <= 0)
+        {
+            disconnect();
+            return false;
+        }
+        received += n;
+    }
+    return true;
+}
+
+// Handles everything already queued, or blocks for one message
+bool SocketLink::poll(const bool wait)
+{
+    Message message;
+    bool any = false;
+
+    while (receive(message, wait && !any))
+    {
+        handle(message);
+        any = true;
+    }
+    return any;
+}
+
+void SocketLink::handle(const Message& message)
+{
+    const ulong time = origin + message.time;
+
+    switch (message.type)
+    {
+        case MESSAGE_START:
+            peer_transfer = time;
+            break;
+
+        case MESSAGE_CANCEL:
+            peer_transfer.reset();
+            break;
+
+        case MESSAGE_DATA:
+            if (machine.scheduler.now() < time && !exchanging)
+                machine.run_until(time);
+            else if (machine.scheduler.now() > time)
+                ++late;
+
+            peer_transfer.reset();
+            send(MESSAGE_REPLY, machine.serial.receive(message.data), message.time);
+            break;
+
+        default:
+            break;
+    }
+}
+
+void SocketLink::disconnect()
+{
+    if (fd >= 0)
+        ::close(fd);
+
+    fd = -1;
+    peer_transfer.reset();
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "serial.hpp"
+#include "../gameboy.hpp"
+
+#include <optional>
+#include <string>
+
+// Link cable to a machine in another process, over a Unix domain socket
+// or loopback TCP ("tcp:<port>"; anything else is a socket path).
+//
+// Times on the wire count master cycles from the moment the link was made,
+// since the two clocks have no common origin otherwise.
+//
+// Neither side waits for the other while no transfer is in flight. The
+// side driving the clock announces a transfer when it writes SC, then sends
+// its byte, stamped with the completion time, and blocks for the reply. The
+// other side is held at the announced completion time until the byte
+// arrives.
+//
+// Delivery is not deterministic: if the announcement only arrives after the
+// other side has run past the completion time, the byte is applied late
+// instead of rolling anything back (see late_exchanges), so replays across
+// a socket can differ. Use LocalLink where runs must be reproducible.
+//
+// A peer that sends nothing for `timeout_ms` while this side waits on it
+// is treated as gone and the link is dropped.
+class SocketLink : public SerialLink
+{
+private:
+    enum MessageType : ubyte
+    {
+        MESSAGE_START,
+        MESSAGE_CANCEL,
+        MESSAGE_DATA,
+        MESSAGE_REPLY
+    };
+
+    struct Message
+    {
+        ulong time;
+        ubyte type;
+        ubyte data;
+        ubyte padding[6];
+    };
+    static_assert(sizeof(Message) == 16);
+
+    GameBoy& machine;
+    int fd;
+    ulong slice;
+    int timeout_ms;
+    ulong origin;
+    std::optional<ulong> peer_transfer;
+    bool exchanging;
+    bool timed_out;
+    ulong late;
+
+public:
+    // The socket is polled every `slice` master cycles
+    SocketLink(GameBoy& machine, const ulong slice = 8 * 512, const int timeout_ms = 5000);
+    SocketLink(const SocketLink&) = delete;
+    SocketLink& operator=(const SocketLink&) = delete;
+    ~SocketLink();
+
+    // Waits for one peer to connect
+    bool listen(const std::string& endpoint);
+    bool connect(const std::string& endpoint);
+    bool connected() const { return fd >= 0; }
+    // The link was dropped because the peer stopped answering
+    bool peer_timed_out() const { return timed_out; }
+
+    ubyte exchange(const Serial& from, const ubyte out, const ulong when) override;
+    void started(const Serial& from, const ulong when) override;
+    void cancelled(const Serial& from) override;
+
+    void run_until(const ulong cycles);
+
+    // Bytes from the peer applied after this machine had run past them
+    ulong late_exchanges() const { return late; }
+
+private:
+    void start(const int socket, const int family);
+    bool send(const MessageType type, const ubyte data, const ulong time);
+    bool receive(Message& message, const bool wait);
+    bool poll(const bool wait);
+    void handle(const Message& message);
+    void disconnect();
+};
@@ -0,0 +1,167 @@
+#include "movie.hpp"
+
+#include "../utils/loader.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+    constexpr char movie_magic[4] = { 'G', 'B', 'M', 'V' };
+
+    void put_varint(std::vector<ubyte>& out, ulong value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(ubyte(value) | 0x80);
+            value >>= 7;
+        }
+        out.push_back(ubyte(value));
+    }
+
+    bool get_varint(const ubyte*& pos, const ubyte* end, ulong& value)
+    {
+        value = 0;
+        for (uint shift = 0; pos < end && shift < 64; shift += 7)
+        {
+            const ubyte b = *pos++;
+            value |= ulong(b & 0x7F) << shift;
+            if (!(b & 0x80))
+                return true;
+        }
+        return false;
+    }
+}
+
+bool Movie::save(const std::string& path) const
+{
+    MovieHeader header{};
+    std::memcpy(header.magic, movie_magic, sizeof(movie_magic));
+    header.version = version;
+    header.rom_hash = rom_hash;
+    header.end_cycle = end_cycle;
+    header.state_size = state.size();
+    header.input_count = inputs.size();
+
+    std::vector<ubyte> log;
+    log.reserve(inputs.size() * 3);
+
+    ulong last = 0;
+    for (const auto& input : inputs)
+    {
+        put_varint(log, input.cycle - last);
+        log.push_back(input.buttons);
+        last = input.cycle;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+
+    // Unique per writer, so two saves of one path never share a temp file
+    const std::string tmp_path = temp_path(path);
+    {
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(state.data()), state.size());
+        out.write(reinterpret_cast<const char*>(log.data()), log.size());
+        if (!out)
+        {
+            std::filesystem::remove(tmp_path, ec);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tmp_path, path, ec);
+    if (!ec)
+        return true;
+
+    std::filesystem::remove(tmp_path, ec);
+    return false;
+}
+
+bool Movie::load(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    const std::vector<ubyte> file{ std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+
+    if (file.size() < sizeof(MovieHeader))
+        return false;
+
+    MovieHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, movie_magic, sizeof(movie_magic)) != 0 || header.version != version
+        || header.state_size > file.size() - sizeof(header))
+        return false;
+
+    const ubyte* pos = file.data() + sizeof(header);
+    const ubyte* end = file.data() + file.size();
+
+    rom_hash = header.rom_hash;
+    end_cycle = header.end_cycle;
+    state.assign(pos, pos + header.state_size);
+    pos += header.state_size;
+
+    inputs.clear();
+    inputs.reserve(std::min<ulong>(header.input_count, end - pos));
+
+    ulong cycle = 0;
+    for (ulong i = 0; i < header.input_count; i++)
+    {
+        ulong delta;
+        if (!get_varint(pos, end, delta) || pos == end)
+            return false;
+
+        cycle += delta;
+        inputs.push_back({ cycle, *pos++ });
+    }
+
+    return pos == end;
+}
+
+MovieRecorder::MovieRecorder(GameBoy& machine) : machine(machine)
+{
+    machine.finish_instruction();
+
+    movie.rom_hash = machine.cartridge.rom_hash();
+    movie.state = machine.save_state();
+
+    machine.joypad.on_input([this](const InputEvent& input) { movie.inputs.push_back(input); });
+}
+
+MovieRecorder::~MovieRecorder()
+{
+    machine.joypad.on_input(nullptr);
+}
+
+Movie& MovieRecorder::finish()
+{
+    machine.joypad.on_input(nullptr);
+    movie.end_cycle = machine.scheduler.now();
+    return movie;
+}
+
+MoviePlayer::MoviePlayer(GameBoy& machine, const Movie& movie) : machine(machine), movie(movie), queued(0) {}
+
+bool MoviePlayer::start()
+{
+    queued = 0;
+    return movie.rom_hash == machine.cartridge.rom_hash() && machine.load_state(movie.state.data(), movie.state.size());
+}
+
+void MoviePlayer::run_until(const ulong cycles)
+{
+    while (machine.scheduler.now() < cycles)
+    {
+        while (queued < movie.inputs.size() && machine.joypad.push(movie.inputs[queued]))
+            queued++;
+
+        // Stop short of the first input that did not fit, so it can be queued in time
+        ulong limit = cycles;
+        if (queued < movie.inputs.size())
+            limit = std::min(limit, std::max(movie.inputs[queued].cycle, machine.scheduler.now() + margin) - margin);
+
+        machine.run_until(std::max(limit, machine.scheduler.now() + 1));
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "../gameboy.hpp"
+
+#include <string>
+#include <vector>
+
+struct MovieHeader
+{
+    char magic[4];
+    uint version;
+    ulong rom_hash;
+    ulong end_cycle;
+    ulong state_size;
+    ulong input_count;
+};
+static_assert(sizeof(MovieHeader) == 40);
+
+// Joypad inputs recorded from a starting state. On disk the header is
+// followed by the state and then one record per input: the cycles since
+// the previous input as a LEB128 varint, and the buttons held.
+struct Movie
+{
+    static constexpr uint version = 1;
+
+    ulong rom_hash{ 0 };
+    ulong end_cycle{ 0 };
+    std::vector<ubyte> state;
+    std::vector<InputEvent> inputs;
+
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+};
+
+// Captures the machine as it is now and every input applied afterwards.
+class MovieRecorder
+{
+private:
+    GameBoy& machine;
+    Movie movie;
+
+public:
+    explicit MovieRecorder(GameBoy& machine);
+    MovieRecorder(const MovieRecorder&) = delete;
+    MovieRecorder& operator=(const MovieRecorder&) = delete;
+    ~MovieRecorder();
+
+    // Stops recording and returns the movie up to the current cycle
+    Movie& finish();
+};
+
+// Restores the starting state and feeds the inputs back through the joypad
+// queue, so each one lands on the cycle it was recorded at.
+class MoviePlayer
+{
+private:
+    // Queued inputs must be seen before their cycle; run_until overshoots
+    // its target by less than one M-cycle
+    static constexpr ulong margin = 8;
+
+    GameBoy& machine;
+    const Movie& movie;
+    size_t queued;
+
+public:
+    MoviePlayer(GameBoy& machine, const Movie& movie);
+
+    // Fails if the movie was recorded with another ROM or its state is invalid
+    bool start();
+
+    void run_until(const ulong cycles);
+    void run() { run_until(movie.end_cycle); }
+    bool finished() const { return machine.scheduler.now() >= movie.end_cycle; }
+};
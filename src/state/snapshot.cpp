@@ -0,0 +1,59 @@
+#include "snapshot.hpp"
+
+#include "../utils/loader.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+    constexpr char snapshot_magic[4] = { 'G', 'B', 'S', 'T' };
+}
+
+bool Snapshot::write(const std::string& path, const SnapshotKind kind, const ulong rom_hash, const std::vector<ubyte>& state)
+{
+    SnapshotHeader header{};
+    std::memcpy(header.magic, snapshot_magic, sizeof(snapshot_magic));
+    header.version = version;
+    header.kind = kind;
+    header.rom_hash = rom_hash;
+    header.size = state.size();
+
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+
+    // Written aside and renamed, so readers never map a partial file
+    const std::string tmp_path = temp_path(path);
+    {
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(state.data()), state.size());
+        if (!out)
+        {
+            std::filesystem::remove(tmp_path, ec);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tmp_path, path, ec);
+    if (!ec)
+        return true;
+
+    std::filesystem::remove(tmp_path, ec);
+    return false;
+}
+
+bool Snapshot::open(const std::string& path, const SnapshotKind kind, const ulong rom_hash)
+{
+    if (!file.open(path) || file.size() < sizeof(SnapshotHeader))
+        return false;
+
+    const auto* header = reinterpret_cast<const SnapshotHeader*>(file.data());
+    if (std::memcmp(header->magic, snapshot_magic, sizeof(snapshot_magic)) != 0 || header->version != version
+        || header->kind != kind || header->rom_hash != rom_hash || header->size != file.size() - sizeof(SnapshotHeader))
+    {
+        file.close();
+        return false;
+    }
+    return true;
+}
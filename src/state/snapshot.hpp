@@ -0,0 +1,46 @@
+#pragma once
+
+#include <types.hpp>
+#include <utils/mapped_file.hpp>
+#include <string>
+#include <vector>
+
+enum SnapshotKind : uint
+{
+    SNAPSHOT_BOOT = 1,
+    SNAPSHOT_WARM = 2
+};
+
+struct SnapshotHeader
+{
+    char magic[4];
+    uint version;
+    uint kind;
+    uint reserved;
+    ulong rom_hash;
+    ulong size;
+};
+static_assert(sizeof(SnapshotHeader) == 32);
+
+// Machine state stored on disk, tagged with the ROM it belongs to. Opening
+// a snapshot maps the file and exposes the state in place. An empty state
+// records that the machine never reached the point the snapshot is for.
+class Snapshot
+{
+private:
+    MappedFile file;
+
+public:
+    // The state stream has no versioning of its own (see state.hpp): bump
+    // this whenever any unit's save_state layout changes, so stale caches
+    // are rebuilt instead of being read as garbage
+    static constexpr uint version = 5;
+
+    static bool write(const std::string& path, const SnapshotKind kind, const ulong rom_hash, const std::vector<ubyte>& state);
+
+    bool open(const std::string& path, const SnapshotKind kind, const ulong rom_hash);
+
+    const ubyte* data() const { return file.data() + sizeof(SnapshotHeader); }
+    size_t size() const { return file.size() - sizeof(SnapshotHeader); }
+    bool empty() const { return size() == 0; }
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <types.hpp>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// Flat binary machine state. Every unit writes and reads its fields in the
+// same order through these; there is no versioning inside the stream.
+class StateWriter
+{
+private:
+    std::vector<ubyte>& out;
+
+public:
+    explicit StateWriter(std::vector<ubyte>& out) : out(out) {}
+
+    void bytes(const void* data, const size_t size)
+    {
+        const ubyte* src = static_cast<const ubyte*>(data);
+        out.insert(out.end(), src, src + size);
+    }
+
+    template <typename T>
+    void value(const T& v)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        bytes(&v, sizeof(T));
+    }
+};
+
+class StateReader
+{
+private:
+    const ubyte* data;
+    size_t size;
+    size_t offset;
+    bool failed;
+
+public:
+    StateReader(const ubyte* data, const size_t size) : data(data), size(size), offset(0), failed(false) {}
+
+    void bytes(void* dest, const size_t count)
+    {
+        if (failed || offset + count > size)
+        {
+            failed = true;
+            return;
+        }
+
+        std::memcpy(dest, data + offset, count);
+        offset += count;
+    }
+
+    template <typename T>
+    void value(T& v)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        bytes(&v, sizeof(T));
+    }
+
+    bool ok() const { return !failed; }
+    bool done() const { return !failed && offset == size; }
+};
@@ -0,0 +1,166 @@
+#include "timer.hpp"
+
+#include <algorithm>
+
+Timer::Timer(Scheduler& scheduler, Interrupts& irq)
+    : scheduler(scheduler), irq(irq), reset_point(0), tima_time(0), tima_base(0), reload_time(0), tma(0), tac(0xF8)
+{
+    scheduler.on(TIMER, [this](ulong when) { overflow(when); });
+}
+
+bool Timer::accepts(const ushort addr) const
+{
+    return addr >= 0xFF04 && addr <= 0xFF07;
+}
+
+ubyte Timer::read(const ushort addr) const
+{
+    switch (addr)
+    {
+        case 0xFF04: return counter(scheduler.cpu_now()) >> 8;
+        case 0xFF05: return tima();
+        case 0xFF06: return tma;
+        default:     return 0xF8 | tac;
+    }
+}
+
+void Timer::write(const ushort addr, const ubyte value)
+{
+    switch (addr)
+    {
+        case 0xFF04:
+            reset_divider();
+            return;
+
+        case 0xFF05:
+            // Writing during the reload delay cancels the reload
+            if (reloading())
+                scheduler.cancel(TIMER);
+            tima_base = value;
+            tima_time = scheduler.cpu_now();
+            break;
+
+        case 0xFF06:
+            tma = value;
+            return;
+
+        default:
+        {
+            sync();
+            const bool was_high = enabled() && selected_bit(scheduler.cpu_now());
+            tac = value & 0x7;
+            if (was_high && !(enabled() && selected_bit(scheduler.cpu_now())))
+                increment();
+            break;
+        }
+    }
+
+    reschedule();
+}
+
+// Resetting the divider is a falling edge if the selected bit was set
+void Timer::reset_divider()
+{
+    sync();
+    if (enabled() && selected_bit(scheduler.cpu_now()))
+        increment();
+    reset_point = scheduler.cpu_now();
+    reschedule();
+}
+
+void Timer::save_state(StateWriter& state) const
+{
+    state.value(reset_point);
+    state.value(tima_time);
+    state.value(tima_base);
+    state.value(reload_time);
+    state.value(tma);
+    state.value(tac);
+}
+
+void Timer::load_state(StateReader& state)
+{
+    state.value(reset_point);
+    state.value(tima_time);
+    state.value(tima_base);
+    state.value(reload_time);
+    state.value(tma);
+    state.value(tac);
+}
+
+uint Timer::edge_shift() const
+{
+    static const uint shifts[4] = { 10, 4, 6, 8 };
+    return shifts[tac & 0x3];
+}
+
+bool Timer::selected_bit(const ulong cpu_time) const
+{
+    return counter(cpu_time) >> (edge_shift() - 1) & 0x1;
+}
+
+// TIMA reads 0 for the M-cycle between an overflow and the TMA reload
+bool Timer::reloading() const
+{
+    return scheduler.pending(TIMER) && scheduler.cpu_now() + 4 >= reload_time;
+}
+
+uint Timer::tima() const
+{
+    if (reloading())
+        return 0x00;
+
+    if (!enabled())
+        return tima_base;
+
+    const ulong edges = (counter(scheduler.cpu_now()) >> edge_shift()) - (counter(tima_time) >> edge_shift());
+    return std::min<ulong>(tima_base + edges, 0xFF);
+}
+
+void Timer::sync()
+{
+    if (reloading())
+        return;
+
+    tima_base = tima();
+    tima_time = scheduler.cpu_now();
+}
+
+void Timer::increment()
+{
+    if (reloading())
+        return;
+
+    if (tima_base == 0xFF)
+    {
+        reload_time = scheduler.cpu_now() + 4;
+        scheduler.schedule_cpu(TIMER, reload_time);
+    }
+    else
+        tima_base++;
+}
+
+void Timer::reschedule()
+{
+    if (reloading())
+        return;
+
+    scheduler.cancel(TIMER);
+    if (!enabled())
+        return;
+
+    const uint shift = edge_shift();
+    const ulong edges = 0x100 - tima_base;
+    const ulong overflow_at = ((counter(tima_time) >> shift) + edges) << shift;
+
+    reload_time = reset_point + overflow_at + 4;
+    scheduler.schedule_cpu(TIMER, reload_time);
+}
+
+void Timer::overflow(const ulong when)
+{
+    tima_base = tma;
+    tima_time = when;
+    irq.IF_TIMER = 1;
+    reschedule();
+}
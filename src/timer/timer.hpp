@@ -0,0 +1,50 @@
+#pragma once
+
+#include <memory/memory_unit.hpp>
+#include <cpu/interrupts.hpp>
+#include <scheduler/scheduler.hpp>
+#include <state/state.hpp>
+
+// DIV/TIMA/TMA/TAC (0xFF04-0xFF07). Nothing counts per cycle: DIV is read
+// off the CPU clock since its last reset, TIMA is a base value plus the
+// falling edges of the selected divider bit since it was taken, and the
+// next overflow is a single scheduled event recomputed on every write.
+class Timer : public MemoryUnit
+{
+private:
+    Scheduler& scheduler;
+    Interrupts& irq;
+
+    ulong reset_point;      // CPU clock when DIV was last reset
+    ulong tima_time;        // CPU clock when tima_base was taken
+    uint tima_base;
+    ulong reload_time;      // CPU clock of the pending TMA reload
+    ubyte tma;
+    ubyte tac;
+
+public:
+    Timer(Scheduler& scheduler, Interrupts& irq);
+
+    bool accepts(const ushort addr) const override;
+    ubyte read(const ushort addr) const override;
+    void write(const ushort addr, const ubyte value) override;
+
+    // A write to DIV, or STOP
+    void reset_divider();
+
+    void save_state(StateWriter& state) const;
+    void load_state(StateReader& state);
+
+private:
+    bool enabled() const { return tac & 0x4; }
+    uint edge_shift() const;
+    ulong counter(const ulong cpu_time) const { return cpu_time - reset_point; }
+    bool selected_bit(const ulong cpu_time) const;
+
+    bool reloading() const;
+    uint tima() const;
+    void sync();
+    void increment();
+    void reschedule();
+    void overflow(const ulong when);
+};
@@ -0,0 +1,74 @@
+#include <state/movie.hpp>
+#include <utils/hash.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+// movie_player <rom> <movie> [-n runs] [-r interval]
+// Plays the movie headless as fast as possible, then prints the emulated
+// speed and a hash of the final state, which must match between runs.
+// Frames are drawn one in `interval`, or never for 0; the state hash does
+// not depend on it.
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::fprintf(stderr, "usage: %s <rom> <movie> [-n runs] [-r interval]\n", argv[0]);
+        return 1;
+    }
+
+    int runs = 1;
+    uint render_interval = 1;
+    for (int i = 3; i + 1 < argc; i += 2)
+    {
+        const std::string flag = argv[i];
+        if (flag == "-n")
+            runs = std::max(1, std::atoi(argv[i + 1]));
+        else if (flag == "-r")
+            render_interval = std::strtoul(argv[i + 1], nullptr, 10);
+    }
+
+    Movie movie;
+    if (!movie.load(argv[2]))
+    {
+        std::fprintf(stderr, "cannot read movie %s\n", argv[2]);
+        return 1;
+    }
+
+    GameBoyOptions options;
+    options.battery = false;
+    options.render_interval = render_interval;
+    GameBoy machine(argv[1], options);
+    if (!machine.cartridge.valid())
+    {
+        std::fprintf(stderr, "cannot load %s\n", argv[1]);
+        return 1;
+    }
+
+    for (int run = 0; run < runs; run++)
+    {
+        MoviePlayer player(machine, movie);
+        if (!player.start())
+        {
+            std::fprintf(stderr, "movie does not match %s\n", argv[1]);
+            return 1;
+        }
+
+        const ulong start_cycle = machine.scheduler.now();
+        const auto start = std::chrono::steady_clock::now();
+
+        player.run();
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const double emulated = double(machine.scheduler.now() - start_cycle) / Scheduler::frequency;
+
+        const auto state = machine.save_state();
+        std::printf("run %d: %.2f s emulated in %.3f s (%.1fx), %zu inputs, state %016llX\n",
+                    run, emulated, seconds, seconds > 0 ? emulated / seconds : 0.0, movie.inputs.size(),
+                    (unsigned long long)hash_bytes(state.data(), state.size()));
+    }
+    return 0;
+}
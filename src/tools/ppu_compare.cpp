@@ -0,0 +1,83 @@
+#include <gameboy.hpp>
+#include <state/movie.hpp>
+#include <utils/hash.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+// ppu_compare <rom> [frames] [movie]
+// Runs the ROM (or the movie) on the pixel FIFO, with the scanline backend
+// drawing the same lines as a shadow, and reports the frames that differ.
+// Both see the same registers at the same dots, so differences come from
+// rendering alone and not from the two backends' mode 3 lengths.
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "usage: %s <rom> [frames] [movie]\n", argv[0]);
+        return 1;
+    }
+
+    const ulong n_frames = argc >= 3 ? std::strtoul(argv[2], nullptr, 10) : 600;
+
+    Movie movie;
+    if (argc >= 4 && !movie.load(argv[3]))
+    {
+        std::fprintf(stderr, "cannot read movie %s\n", argv[3]);
+        return 1;
+    }
+
+    GameBoyOptions options;
+    options.battery = false;
+    options.renderer = Renderer::PIXEL_FIFO;
+
+    GameBoy machine(argv[1], options);
+    if (!machine.cartridge.valid())
+    {
+        std::fprintf(stderr, "cannot load %s\n", argv[1]);
+        return 1;
+    }
+    machine.ppu.add_shadow(Renderer::SCANLINE);
+
+    std::unique_ptr<MoviePlayer> player;
+    if (argc >= 4)
+    {
+        player = std::make_unique<MoviePlayer>(machine, movie);
+        if (!player->start())
+        {
+            std::fprintf(stderr, "movie does not match %s\n", argv[1]);
+            return 1;
+        }
+    }
+
+    ulong mismatches = 0;
+    ulong last_frame = machine.ppu.frame_count();
+    const ulong start = machine.scheduler.now();
+    for (ulong step = 1; step <= n_frames; step++)
+    {
+        const ulong until = start + step * GameBoy::frame_cycles;
+        if (player)
+            player->run_until(until);
+        else
+            machine.run_until(until);
+
+        // Nothing new to compare while the LCD is off
+        if (machine.ppu.frame_count() == last_frame)
+            continue;
+        last_frame = machine.ppu.frame_count();
+
+        const ulong fifo = machine.ppu.frame_hash();
+        const ulong scanline = hash_bytes(reinterpret_cast<const ubyte*>(machine.ppu.shadow_frame().data()), sizeof(Framebuffer));
+        if (fifo != scanline)
+        {
+            if (mismatches++ < 10)
+                std::printf("frame %lu: scanline %016llX, fifo %016llX\n", last_frame,
+                            (unsigned long long)scanline, (unsigned long long)fifo);
+        }
+    }
+
+    std::printf("%lu of %lu frames differ\n", mismatches, n_frames);
+    return mismatches ? 2 : 0;
+}
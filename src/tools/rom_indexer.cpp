@@ -0,0 +1,79 @@
+#include <cartridge/rom_index.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// rom_indexer <index> <dir>... [-j threads]   builds the index
+// rom_indexer <index> --find <hash>           resolves a ROM by content hash
+// rom_indexer <index> --list                  prints every entry
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::fprintf(stderr, "usage: %s <index> <dir>... [-j threads] | --find <hash> | --list\n", argv[0]);
+        return 1;
+    }
+
+    const std::string index_path = argv[1];
+    const std::string command = argv[2];
+
+    if (command == "--find" || command == "--list")
+    {
+        RomIndex index;
+        if (!index.open(index_path))
+        {
+            std::fprintf(stderr, "cannot open index %s\n", index_path.c_str());
+            return 1;
+        }
+
+        auto print = [&](const RomIndexEntry& entry)
+        {
+            std::printf("%016llX  %-16.16s  type 0x%02X  rom 0x%02X  ram 0x%02X  %.*s\n",
+                        (unsigned long long)entry.hash, entry.title, entry.type, entry.rom_size, entry.ram_size,
+                        (int)index.path(entry).size(), index.path(entry).data());
+        };
+
+        if (command == "--list")
+        {
+            for (const auto& entry : index)
+                print(entry);
+            return 0;
+        }
+
+        if (argc < 4)
+            return 1;
+
+        const RomIndexEntry* entry = index.find(std::strtoull(argv[3], nullptr, 16));
+        if (!entry)
+            return 2;
+
+        print(*entry);
+        return 0;
+    }
+
+    std::vector<std::string> dirs;
+    unsigned n_threads = 0;
+    for (int i = 2; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (arg == "-j" && i + 1 < argc)
+            n_threads = std::atoi(argv[++i]);
+        else
+            dirs.push_back(arg);
+    }
+
+    std::vector<std::string> errors;
+    const bool written = RomIndex::build(dirs, index_path, n_threads, &errors);
+
+    for (const auto& error : errors)
+        std::fprintf(stderr, "skipped %s\n", error.c_str());
+
+    if (!written)
+    {
+        std::fprintf(stderr, "cannot write index %s\n", index_path.c_str());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <types.hpp>
+#include <cstring>
+#include <cstddef>
+
+// 64-bit content hash, consumes the input eight bytes at a time.
+inline ulong hash_bytes(const ubyte* data, const size_t size) noexcept
+{
+    constexpr ulong k = 0x9E3779B97F4A7C15;
+
+    // Empty input may come as a null pointer, which memcpy must not see;
+    // this is the value the full mix gives for it
+    if (size == 0)
+        return 0;
+
+    ulong h = size * k;
+    size_t i = 0;
+
+    for (; i + 8 <= size; i += 8)
+    {
+        ulong word;
+        std::memcpy(&word, data + i, 8);
+        h = (h ^ word) * k;
+        h ^= h >> 29;
+    }
+
+    ulong tail = 0;
+    std::memcpy(&tail, data + i, size - i);
+    h = (h ^ tail) * k;
+
+    h ^= h >> 32;
+    h *= 0xD6E8FEB86659FD93;
+    h ^= h >> 32;
+    return h;
+}
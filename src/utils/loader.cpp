@@ -1,23 +1,25 @@
 #include "loader.hpp"
 
+#include <atomic>
 #include <fstream>
-#include <iterator>
+#include <unistd.h>
 
 std::vector<ubyte> read_file(const std::string& path)
 {
-    std::ifstream file(path, std::ios::binary);
-    file.unsetf(std::ios::skipws);
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return {};
 
-    file.seekg(0, std::ios::end);
-    std::streampos size = file.tellg();
+    std::vector<ubyte> res(file.tellg());
     file.seekg(0, std::ios::beg);
+    file.read(reinterpret_cast<char*>(res.data()), res.size());
+    res.resize(file.gcount());
 
-    std::vector<ubyte> res;
-    res.reserve(size);
-
-    std::copy(std::istream_iterator<ubyte>(file),
-              std::istream_iterator<ubyte>(),
-              std::back_inserter(res));
-    
     return res;
-}
\ No newline at end of file
+}
+
+std::string temp_path(const std::string& path)
+{
+    static std::atomic<uint> counter{ 0 };
+    return path + "." + std::to_string(getpid()) + "." + std::to_string(counter++) + ".tmp";
+}
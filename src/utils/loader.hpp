@@ -4,4 +4,8 @@
 #include <vector>
 #include <string>
 
-std::vector<ubyte> read_file(const std::string& path);
\ No newline at end of file
+std::vector<ubyte> read_file(const std::string& path);
+
+// Name next to `path` for writing a file aside before renaming it over
+// `path`; unique across processes and threads
+std::string temp_path(const std::string& path);
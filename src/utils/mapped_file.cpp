@@ -0,0 +1,139 @@
+#include "mapped_file.hpp"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <utility>
+
+MappedFile::MappedFile() : mapping(nullptr), length(0), lock_fd(-1), blank(false) {}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : mapping(std::exchange(other.mapping, nullptr)), length(std::exchange(other.length, 0)),
+      lock_fd(std::exchange(other.lock_fd, -1)), blank(std::exchange(other.blank, false))
+{}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        mapping = std::exchange(other.mapping, nullptr);
+        length = std::exchange(other.length, 0);
+        lock_fd = std::exchange(other.lock_fd, -1);
+        blank = std::exchange(other.blank, false);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const std::string& path)
+{
+    close();
+
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    void* res = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (res == MAP_FAILED)
+        return false;
+
+    mapping = static_cast<ubyte*>(res);
+    length = info.st_size;
+    return true;
+}
+
+bool MappedFile::open_writable(const std::string& path, const size_t size, std::initializer_list<size_t> shorter)
+{
+    close();
+
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+        return false;
+
+    // The lock is tied to this descriptor, so it also tells apart two
+    // mappings in the same process
+    const bool shared = flock(fd, LOCK_EX | LOCK_NB) == 0;
+
+    // A file of any other size belongs to something else and is left alone
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    const size_t existing = info.st_size;
+    const bool accepted = existing == 0 || existing == size || std::find(shorter.begin(), shorter.end(), existing) != shorter.end();
+
+    // Only the lock holder may size the file
+    if (!accepted || (shared && existing != size && ftruncate(fd, size) != 0))
+    {
+        ::close(fd);
+        return false;
+    }
+
+    // A file that is shorter than the mapping cannot back it, so other
+    // instances copy what there is into anonymous memory
+    void* res;
+    if (shared || existing == size)
+        res = mmap(nullptr, size, PROT_READ | PROT_WRITE, shared ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+    else
+    {
+        res = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (res != MAP_FAILED && existing && pread(fd, res, existing, 0) != ssize_t(existing))
+        {
+            munmap(res, size);
+            res = MAP_FAILED;
+        }
+    }
+
+    if (res == MAP_FAILED || !shared)
+        ::close(fd);
+
+    if (res == MAP_FAILED)
+        return false;
+
+    mapping = static_cast<ubyte*>(res);
+    length = size;
+    lock_fd = shared ? fd : -1;
+    blank = !shared && existing == 0;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (mapping)
+        munmap(mapping, length);
+    if (lock_fd >= 0)
+        ::close(lock_fd);
+
+    mapping = nullptr;
+    length = 0;
+    lock_fd = -1;
+    blank = false;
+}
+
+bool MappedFile::sync(const size_t offset, const size_t count, const bool blocking)
+{
+    const size_t page = sysconf(_SC_PAGESIZE);
+    const size_t begin = offset & ~(page - 1);
+
+    return msync(mapping + begin, offset + count - begin, blocking ? MS_SYNC : MS_ASYNC) == 0;
+}
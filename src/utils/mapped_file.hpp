@@ -0,0 +1,42 @@
+#pragma once
+
+#include <types.hpp>
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+
+// Memory mapping of a whole file. Read-only mappings are private. A
+// writable mapping is shared, so stores reach the file through the page
+// cache, as long as no other writable mapping of the file is open in any
+// process; later ones get a private copy instead, or blank memory when
+// there is nothing to copy yet.
+class MappedFile
+{
+private:
+    ubyte* mapping;
+    size_t length;
+    int lock_fd;            // Held open by the shared writer
+    bool blank;             // Private and not backed by any file contents
+
+public:
+    MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    ~MappedFile();
+
+    bool open(const std::string& path);
+    // Creates the file with `size` bytes if it is empty, and grows it if it
+    // has one of the `shorter` sizes; fails if it has any other size
+    bool open_writable(const std::string& path, const size_t size, std::initializer_list<size_t> shorter = {});
+    void close();
+
+    bool sync(const size_t offset, const size_t count, const bool blocking = true);
+
+    bool is_open() const { return mapping != nullptr; }
+    bool is_shared() const { return lock_fd >= 0; }
+    bool is_blank() const { return blank; }
+    ubyte* data() const { return mapping; }
+    size_t size() const { return length; }
+};
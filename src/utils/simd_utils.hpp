@@ -0,0 +1,44 @@
+#pragma once
+
+#include <types.hpp>
+#include <cstddef>
+#include <cstring>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+    #include <arm_neon.h>
+#endif
+
+// Sum of every byte in the buffer.
+inline ulong sum_bytes(const ubyte* data, const size_t size) noexcept
+{
+    ulong sum = 0;
+    size_t i = 0;
+
+    #if defined(__SSE2__)
+        const __m128i zero = _mm_setzero_si128();
+        __m128i acc = zero;
+        for (; i + 16 <= size; i += 16)
+            acc = _mm_add_epi64(acc, _mm_sad_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), zero));
+        sum = _mm_cvtsi128_si64(acc) + _mm_cvtsi128_si64(_mm_unpackhi_epi64(acc, acc));
+    #elif defined(__ARM_NEON) || defined(__aarch64__)
+        uint64x2_t acc = vdupq_n_u64(0);
+        for (; i + 16 <= size; i += 16)
+            acc = vpadalq_u32(acc, vpaddlq_u16(vpaddlq_u8(vld1q_u8(data + i))));
+        sum = vgetq_lane_u64(acc, 0) + vgetq_lane_u64(acc, 1);
+    #else
+        for (; i + 8 <= size; i += 8)
+        {
+            ulong word;
+            std::memcpy(&word, data + i, 8);
+            word = (word & 0x00FF00FF00FF00FF) + ((word >> 8) & 0x00FF00FF00FF00FF);
+            word = (word & 0x0000FFFF0000FFFF) + ((word >> 16) & 0x0000FFFF0000FFFF);
+            sum += (word & 0xFFFFFFFF) + (word >> 32);
+        }
+    #endif
+
+    for (; i < size; i++)
+        sum += data[i];
+    return sum;
+}
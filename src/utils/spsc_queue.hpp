@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Bounded ring buffer for one producer thread and one consumer thread.
+// Each side only writes its own index, so neither push nor pop takes a lock.
+template<typename T, size_t Capacity>
+class SpscQueue
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+private:
+    static constexpr size_t mask = Capacity - 1;
+
+    std::array<T, Capacity> items;
+    alignas(64) std::atomic<size_t> head{ 0 };  // Next item to pop
+    alignas(64) std::atomic<size_t> tail{ 0 };  // Next slot to push
+
+public:
+    // Producer side; false if the queue is full
+    bool push(const T& item)
+    {
+        const size_t pos = tail.load(std::memory_order_relaxed);
+        if (pos - head.load(std::memory_order_acquire) == Capacity)
+            return false;
+
+        items[pos & mask] = item;
+        tail.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; nullptr if the queue is empty
+    const T* peek() const
+    {
+        const size_t pos = head.load(std::memory_order_relaxed);
+        if (pos == tail.load(std::memory_order_acquire))
+            return nullptr;
+
+        return &items[pos & mask];
+    }
+
+    bool pop(T& item)
+    {
+        const T* front = peek();
+        if (!front)
+            return false;
+
+        item = *front;
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const
+    {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+};
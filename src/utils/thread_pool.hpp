@@ -0,0 +1,90 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+class ThreadPool
+{
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> jobs;
+
+    std::mutex mutex;
+    std::condition_variable job_ready;
+    std::condition_variable all_done;
+    size_t running{ 0 };
+    bool stopping{ false };
+
+public:
+    explicit ThreadPool(unsigned n_threads = std::thread::hardware_concurrency())
+    {
+        if (n_threads == 0)
+            n_threads = 1;
+
+        for (unsigned i = 0; i < n_threads; i++)
+            workers.emplace_back([this] { work(); });
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        job_ready.notify_all();
+
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    void submit(std::function<void()> job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push(std::move(job));
+        }
+        job_ready.notify_one();
+    }
+
+    // Blocks until every submitted job has finished.
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        all_done.wait(lock, [this] { return jobs.empty() && running == 0; });
+    }
+
+private:
+    void work()
+    {
+        while (true)
+        {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                job_ready.wait(lock, [this] { return stopping || !jobs.empty(); });
+                if (jobs.empty())
+                    return;
+
+                job = std::move(jobs.front());
+                jobs.pop();
+                running++;
+            }
+
+            job();
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                running--;
+                if (jobs.empty() && running == 0)
+                    all_done.notify_all();
+            }
+        }
+    }
+};
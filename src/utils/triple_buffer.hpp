@@ -0,0 +1,50 @@
+#pragma once
+
+#include <types.hpp>
+#include <array>
+#include <atomic>
+
+// Three buffers handed from one producer thread to one consumer thread
+// without locks or copies. The producer fills the back buffer and
+// publishes it by swapping it with the middle one; the consumer takes the
+// middle one in exchange for its front buffer when a fresh one is there.
+// Neither side ever waits, and the consumer always gets the newest
+// complete buffer, never one being written.
+template<typename T>
+class TripleBuffer
+{
+private:
+    static constexpr ubyte fresh = 0x4;     // Set in `middle` when it was published after the last take
+
+    std::array<T, 3> buffers{};
+    alignas(64) std::atomic<ubyte> middle{ 1 };
+    alignas(64) ubyte back_index{ 0 };      // Producer side only
+    ubyte latest_index{ 1 };
+    alignas(64) ubyte front_index{ 2 };     // Consumer side only
+
+public:
+    // Producer side
+    T& back() { return buffers[back_index]; }
+
+    void publish()
+    {
+        latest_index = back_index;
+        back_index = middle.exchange(back_index | fresh, std::memory_order_acq_rel) & 3;
+    }
+
+    // Last buffer published; the producer only reads it, so the consumer
+    // may hold it at the same time
+    const T& latest() const { return buffers[latest_index]; }
+
+    // Consumer side; true if a newer buffer was taken
+    bool update()
+    {
+        if (!(middle.load(std::memory_order_relaxed) & fresh))
+            return false;
+
+        front_index = middle.exchange(front_index, std::memory_order_acq_rel) & 3;
+        return true;
+    }
+
+    const T& front() const { return buffers[front_index]; }
+};